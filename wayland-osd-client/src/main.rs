@@ -2,7 +2,7 @@ use anyhow::Context;
 use clap::{Parser, Subcommand};
 use serde_json::json;
 use std::fs::OpenOptions;
-use std::io::Write;
+use std::io::{BufRead, Write};
 
 const PIPE_PATH: &str = "/tmp/wayland-osd.pipe";
 
@@ -47,6 +47,8 @@ enum Commands {
         /// Message to display
         message: String,
     },
+    /// Run persistently, forwarding NUL-delimited JSON messages read from stdin
+    Listen,
 }
 
 struct OsdClient;
@@ -131,6 +133,38 @@ fn main() -> anyhow::Result<()> {
             });
             client.send_message(&message.to_string())?;
         }
+        Commands::Listen => {
+            let stdin = std::io::stdin();
+            let mut reader = std::io::BufReader::new(stdin.lock());
+            let mut buffer = Vec::new();
+            loop {
+                buffer.clear();
+                let n = reader
+                    .read_until(0, &mut buffer)
+                    .context("Failed to read from stdin")?;
+                if n == 0 {
+                    // Writer closed the pipe, we're done
+                    break;
+                }
+                if buffer.last() == Some(&0) {
+                    buffer.pop();
+                }
+                let message = String::from_utf8_lossy(&buffer);
+                let message = message.trim();
+                if message.is_empty() {
+                    continue;
+                }
+                if let Err(e) = serde_json::from_str::<serde_json::Value>(message) {
+                    eprintln!("Ignoring invalid JSON message: {}", e);
+                    continue;
+                }
+                // Keep listening even if a single delivery fails so a slow or
+                // restarting server doesn't tear down the stream
+                if let Err(e) = client.send_message(message) {
+                    eprintln!("Failed to deliver message: {}", e);
+                }
+            }
+        }
     }
 
     Ok(())
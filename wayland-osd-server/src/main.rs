@@ -25,6 +25,10 @@ const ICON_VOLUME_LOW: &str = include_str!("../assets/sink-volume-low-symbolic.s
 const ICON_VOLUME_MUTED: &str = include_str!("../assets/sink-volume-muted-symbolic.svg");
 const ICON_VOLUME_OVERAMPLIFIED: &str =
     include_str!("../assets/sink-volume-overamplified-symbolic.svg");
+const ICON_SOURCE_VOLUME_HIGH: &str = include_str!("../assets/source-volume-high-symbolic.svg");
+const ICON_SOURCE_VOLUME_MEDIUM: &str = include_str!("../assets/source-volume-medium-symbolic.svg");
+const ICON_SOURCE_VOLUME_LOW: &str = include_str!("../assets/source-volume-low-symbolic.svg");
+const ICON_SOURCE_VOLUME_MUTED: &str = include_str!("../assets/source-volume-muted-symbolic.svg");
 const ICON_BRIGHTNESS: &str = include_str!("../assets/display-brightness-symbolic.svg");
 
 #[derive(Debug, Serialize, Deserialize, Clone)]
@@ -74,6 +78,23 @@ fn get_volume_icon(value: i32, muted: bool) -> gtk::Image {
     load_icon_from_string(icon_data)
 }
 
+fn get_source_volume_icon(value: i32, muted: bool) -> gtk::Image {
+    if muted {
+        return load_icon_from_string(ICON_SOURCE_VOLUME_MUTED);
+    }
+
+    // No overamplified variant exists for sources; reuse the high icon
+    let icon_data = if value > 66 {
+        ICON_SOURCE_VOLUME_HIGH
+    } else if value > 33 {
+        ICON_SOURCE_VOLUME_MEDIUM
+    } else {
+        ICON_SOURCE_VOLUME_LOW
+    };
+
+    load_icon_from_string(icon_data)
+}
+
 fn setup_css() -> gtk::CssProvider {
     let provider = gtk::CssProvider::new();
     let css_data = "
@@ -229,11 +250,12 @@ fn handle_message(ui: &UiElements, msg: OsdMessage) {
     debug!("Handling message: {:?}", msg);
 
     match msg.message_type.as_str() {
-        "volume" => {
+        "volume" | "source-volume" => {
+            let is_source = msg.message_type == "source-volume";
             if let (Some(value), Some(max)) = (msg.value, msg.max_value) {
                 debug!(
-                    "Volume update - level: {}, max: {}, muted: {:?}",
-                    value, max, msg.muted
+                    "Volume update ({}) - level: {}, max: {}, muted: {:?}",
+                    msg.message_type, value, max, msg.muted
                 );
                 let fraction = value as f64 / max as f64;
                 ui.progress_bar.set_fraction(fraction);
@@ -266,7 +288,11 @@ fn handle_message(ui: &UiElements, msg: OsdMessage) {
                 }
 
                 // Update icon based on volume level and muted state
-                let new_icon = get_volume_icon(value, msg.muted.unwrap_or(false));
+                let new_icon = if is_source {
+                    get_source_volume_icon(value, msg.muted.unwrap_or(false))
+                } else {
+                    get_volume_icon(value, msg.muted.unwrap_or(false))
+                };
                 if let Some(paintable) = new_icon.paintable() {
                     ui.icon.set_paintable(Some(&paintable));
                     trace!("Updated volume icon");
@@ -0,0 +1,45 @@
+#define _GNU_SOURCE
+#include "alloc-count.h"
+
+#ifdef ALLOC_COUNT
+
+#include <stdatomic.h>
+#include <stddef.h>
+
+// glibc's real allocator entry points, still reachable with the public
+// symbols interposed by the definitions below. free() is not interposed:
+// the pointers handed out are ordinary glibc allocations.
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t nmemb, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+
+static _Atomic uint64_t total;
+
+void *malloc(size_t size) {
+    atomic_fetch_add_explicit(&total, 1, memory_order_relaxed);
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t nmemb, size_t size) {
+    atomic_fetch_add_explicit(&total, 1, memory_order_relaxed);
+    return __libc_calloc(nmemb, size);
+}
+
+void *realloc(void *ptr, size_t size) {
+    atomic_fetch_add_explicit(&total, 1, memory_order_relaxed);
+    return __libc_realloc(ptr, size);
+}
+
+bool alloc_count_active(void) { return true; }
+
+uint64_t alloc_count_total(void) {
+    return atomic_load_explicit(&total, memory_order_relaxed);
+}
+
+#else
+
+bool alloc_count_active(void) { return false; }
+
+uint64_t alloc_count_total(void) { return 0; }
+
+#endif
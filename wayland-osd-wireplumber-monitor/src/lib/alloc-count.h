@@ -0,0 +1,18 @@
+#ifndef ALLOC_COUNT_H
+#define ALLOC_COUNT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Heap-allocation counter for debug builds. Compiled with ALLOC_COUNT
+// defined (`defines += ALLOC_COUNT`), this translation unit interposes
+// malloc/calloc/realloc over glibc's and counts every call in the
+// process, including those made inside GLib. The monitor samples the
+// counter around event handling so the SIGUSR1 dump can prove how many
+// steady-state events touched the heap. Without the define both
+// functions return constants and nothing is interposed.
+
+bool alloc_count_active(void);
+uint64_t alloc_count_total(void);
+
+#endif
@@ -0,0 +1,334 @@
+#define _GNU_SOURCE
+#include "device-map.h"
+#include "log.h"
+
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define NO_MATCH UINT32_MAX
+
+// Trie/automaton node. Children are kept as a first-child/next-sibling
+// list instead of a 256-entry table so a large pattern set stays compact.
+typedef struct {
+    uint32_t first_child;
+    uint32_t next_sibling;
+    uint32_t fail;
+    // Lowest mapping index whose pattern ends at (or is a suffix of the
+    // path to) this node; NO_MATCH if none.
+    uint32_t match;
+    unsigned char ch;
+} AcNode;
+
+struct DeviceMapIndex {
+    AcNode *nodes;
+    uint32_t node_count;
+    uint32_t capacity;
+};
+
+static uint32_t ac_find_child(const DeviceMapIndex *index, uint32_t node, unsigned char ch) {
+    for (uint32_t child = index->nodes[node].first_child; child != 0;
+         child = index->nodes[child].next_sibling) {
+        if (index->nodes[child].ch == ch) {
+            return child;
+        }
+    }
+    return 0;
+}
+
+static uint32_t ac_add_node(DeviceMapIndex *index, unsigned char ch) {
+    if (index->node_count >= index->capacity) {
+        uint32_t new_capacity = index->capacity * 2;
+        AcNode *new_nodes = realloc(index->nodes, new_capacity * sizeof(AcNode));
+        if (!new_nodes) {
+            return 0;
+        }
+        index->nodes = new_nodes;
+        index->capacity = new_capacity;
+    }
+
+    uint32_t id = index->node_count++;
+    index->nodes[id] = (AcNode){
+        .first_child = 0,
+        .next_sibling = 0,
+        .fail = 0,
+        .match = NO_MATCH,
+        .ch = ch,
+    };
+    return id;
+}
+
+static bool ac_insert(DeviceMapIndex *index, const char *pattern, uint32_t mapping_index) {
+    uint32_t node = 0;
+    for (const char *p = pattern; *p != '\0'; p++) {
+        unsigned char ch = (unsigned char)*p;
+        uint32_t child = ac_find_child(index, node, ch);
+        if (child == 0) {
+            child = ac_add_node(index, ch);
+            if (child == 0) {
+                return false;
+            }
+            index->nodes[child].next_sibling = index->nodes[node].first_child;
+            index->nodes[node].first_child = child;
+        }
+        node = child;
+    }
+    if (mapping_index < index->nodes[node].match) {
+        index->nodes[node].match = mapping_index;
+    }
+    return true;
+}
+
+// Breadth-first pass assigning failure links and folding each node's
+// suffix matches into its own match slot, so the scan never has to walk
+// output chains.
+static bool ac_build_links(DeviceMapIndex *index) {
+    uint32_t *queue = malloc(index->node_count * sizeof(uint32_t));
+    if (!queue) {
+        return false;
+    }
+
+    size_t head = 0;
+    size_t tail = 0;
+    for (uint32_t child = index->nodes[0].first_child; child != 0;
+         child = index->nodes[child].next_sibling) {
+        index->nodes[child].fail = 0;
+        queue[tail++] = child;
+    }
+
+    while (head < tail) {
+        uint32_t node = queue[head++];
+        for (uint32_t child = index->nodes[node].first_child; child != 0;
+             child = index->nodes[child].next_sibling) {
+            unsigned char ch = index->nodes[child].ch;
+            uint32_t fail = index->nodes[node].fail;
+            uint32_t next;
+            while ((next = ac_find_child(index, fail, ch)) == 0 && fail != 0) {
+                fail = index->nodes[fail].fail;
+            }
+            if (next == 0) {
+                next = ac_find_child(index, 0, ch);
+            }
+            index->nodes[child].fail = (next != 0 && next != child) ? next : 0;
+            if (index->nodes[index->nodes[child].fail].match < index->nodes[child].match) {
+                index->nodes[child].match = index->nodes[index->nodes[child].fail].match;
+            }
+            queue[tail++] = child;
+        }
+    }
+
+    free(queue);
+    return true;
+}
+
+static void free_device_map_index(DeviceMapIndex *index) {
+    if (index) {
+        free(index->nodes);
+        free(index);
+    }
+}
+
+static DeviceMapIndex *build_device_map_index(const DeviceMapping *mappings, size_t count) {
+    DeviceMapIndex *index = malloc(sizeof(DeviceMapIndex));
+    if (!index) {
+        return NULL;
+    }
+
+    index->capacity = 64;
+    index->node_count = 0;
+    index->nodes = malloc(index->capacity * sizeof(AcNode));
+    if (!index->nodes) {
+        free(index);
+        return NULL;
+    }
+    ac_add_node(index, 0); // root
+
+    for (size_t i = 0; i < count; i++) {
+        if (!ac_insert(index, mappings[i].pattern, (uint32_t)i)) {
+            free_device_map_index(index);
+            return NULL;
+        }
+    }
+
+    if (!ac_build_links(index)) {
+        free_device_map_index(index);
+        return NULL;
+    }
+
+    return index;
+}
+
+void free_device_mappings(DeviceMappings *mappings) {
+    // The mapping array and every string live in one arena allocation
+    free(mappings->mappings);
+    free_device_map_index(mappings->index);
+    mappings->mappings = NULL;
+    mappings->count = 0;
+    mappings->index = NULL;
+}
+
+// One line of the mapping file as found in the mapped image. A line is
+// usable when it is non-empty, not a comment and contains a separator.
+static bool parse_mapping_line(const char *line, size_t line_len,
+                               const char **separator) {
+    if (line_len == 0 || line[0] == '#') {
+        return false;
+    }
+    *separator = memchr(line, '=', line_len);
+    return *separator != NULL;
+}
+
+bool load_device_mappings(const char *filename, DeviceMappings *mappings) {
+    mappings->mappings = NULL;
+    mappings->count = 0;
+    mappings->index = NULL;
+
+    if (!filename) {
+        return true;
+    }
+
+    int fd = open(filename, O_RDONLY);
+    if (fd == -1) {
+        log_error("Failed to open device mapping file: %s", filename);
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) == -1) {
+        log_error("Failed to stat device mapping file: %s", filename);
+        close(fd);
+        return false;
+    }
+
+    if (st.st_size == 0) {
+        close(fd);
+        return true;
+    }
+
+    size_t file_size = (size_t)st.st_size;
+    char *data = mmap(NULL, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        log_error("Failed to mmap device mapping file: %s", filename);
+        return false;
+    }
+
+    // First pass: count usable entries and the string bytes they need, so
+    // the whole table fits in one allocation
+    size_t count = 0;
+    size_t string_bytes = 0;
+    for (size_t pos = 0; pos < file_size;) {
+        const char *line = data + pos;
+        const char *newline = memchr(line, '\n', file_size - pos);
+        size_t line_len = newline ? (size_t)(newline - line) : file_size - pos;
+        pos += line_len + 1;
+
+        const char *separator;
+        if (parse_mapping_line(line, line_len, &separator)) {
+            count++;
+            string_bytes += line_len + 2; // both strings, two NULs
+        }
+    }
+
+    if (count == 0) {
+        munmap(data, file_size);
+        return true;
+    }
+
+    // Single arena: the mapping array followed by all pattern/display
+    // strings, freed as one block in free_device_mappings()
+    size_t arena_size = count * sizeof(DeviceMapping) + string_bytes;
+    char *arena = malloc(arena_size);
+    if (!arena) {
+        munmap(data, file_size);
+        return false;
+    }
+
+    DeviceMapping *table = (DeviceMapping *)arena;
+    char *strings = arena + count * sizeof(DeviceMapping);
+
+    // Second pass: copy each entry's strings into the arena
+    size_t entry = 0;
+    for (size_t pos = 0; pos < file_size;) {
+        const char *line = data + pos;
+        const char *newline = memchr(line, '\n', file_size - pos);
+        size_t line_len = newline ? (size_t)(newline - line) : file_size - pos;
+        pos += line_len + 1;
+
+        const char *separator;
+        if (!parse_mapping_line(line, line_len, &separator)) {
+            continue;
+        }
+
+        size_t pattern_len = (size_t)(separator - line);
+        size_t name_len = line_len - pattern_len - 1;
+
+        table[entry].pattern = strings;
+        memcpy(strings, line, pattern_len);
+        strings[pattern_len] = '\0';
+        strings += pattern_len + 1;
+
+        table[entry].display_name = strings;
+        memcpy(strings, separator + 1, name_len);
+        strings[name_len] = '\0';
+        strings += name_len + 1;
+
+        entry++;
+    }
+
+    munmap(data, file_size);
+    mappings->mappings = table;
+    mappings->count = count;
+
+    mappings->index = build_device_map_index(mappings->mappings, count);
+    if (!mappings->index) {
+        log_error("Failed to build device mapping index");
+        free_device_mappings(mappings);
+        return false;
+    }
+
+    return true;
+}
+
+const char* get_mapped_device_name(const DeviceMappings *mappings, const char *device_name) {
+    if (!mappings || !mappings->mappings || !device_name) {
+        return device_name;
+    }
+
+    if (!mappings->index) {
+        // No index (shouldn't happen with a non-empty table); fall back to
+        // the linear scan
+        for (size_t i = 0; i < mappings->count; i++) {
+            if (strstr(device_name, mappings->mappings[i].pattern) != NULL) {
+                return mappings->mappings[i].display_name;
+            }
+        }
+        return device_name;
+    }
+
+    const DeviceMapIndex *index = mappings->index;
+    uint32_t state = 0;
+    uint32_t best = NO_MATCH;
+
+    for (const char *p = device_name; *p != '\0'; p++) {
+        unsigned char ch = (unsigned char)*p;
+        uint32_t next;
+        while ((next = ac_find_child(index, state, ch)) == 0 && state != 0) {
+            state = index->nodes[state].fail;
+        }
+        state = next; // root (0) when no transition exists
+        if (index->nodes[state].match < best) {
+            best = index->nodes[state].match;
+        }
+    }
+
+    if (best == NO_MATCH) {
+        return device_name;
+    }
+    return mappings->mappings[best].display_name;
+}
@@ -0,0 +1,32 @@
+#ifndef DEVICE_MAP_H
+#define DEVICE_MAP_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef struct {
+    char *pattern;
+    char *display_name;
+} DeviceMapping;
+
+// Aho-Corasick automaton over all patterns, built once at load time so
+// lookups cost O(device name length) instead of O(mapping count).
+typedef struct DeviceMapIndex DeviceMapIndex;
+
+typedef struct {
+    DeviceMapping *mappings;
+    size_t count;
+    DeviceMapIndex *index;
+} DeviceMappings;
+
+// Load "pattern=display_name" mappings from filename and build the match
+// index. A NULL filename yields an empty (always pass-through) table.
+bool load_device_mappings(const char *filename, DeviceMappings *mappings);
+
+// Return the display name of the first mapping (in file order) whose
+// pattern occurs in device_name, or device_name itself when none match.
+const char *get_mapped_device_name(const DeviceMappings *mappings, const char *device_name);
+
+void free_device_mappings(DeviceMappings *mappings);
+
+#endif
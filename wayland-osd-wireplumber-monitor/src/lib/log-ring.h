@@ -0,0 +1,34 @@
+/*
+ * On-disk format of the binary ring-file log sink (see log_add_ringfile
+ * in log.h). Shared with the offline logdump decoder, so any change here
+ * must bump LOG_RING_VERSION.
+ */
+
+#ifndef LOG_RING_H
+#define LOG_RING_H
+
+#include <stdint.h>
+
+#define LOG_RING_MAGIC "WOSDRING"
+#define LOG_RING_VERSION 1
+#define LOG_RING_TEXT_MAX 240
+
+typedef struct {
+  char magic[8];
+  uint32_t version;
+  uint32_t record_count; /* capacity of the record area */
+  uint64_t next_index;   /* total records ever written; slot = index % count */
+} LogRingHeader;
+
+/* Fixed-size record: wrap-around needs no parsing and a torn tail record
+ * can't corrupt its neighbours. */
+typedef struct {
+  uint64_t mono_ns;  /* CLOCK_MONOTONIC at emission */
+  uint32_t line;
+  uint8_t level;
+  uint8_t file_len;
+  uint16_t msg_len;
+  char text[LOG_RING_TEXT_MAX]; /* file name followed by the formatted message */
+} LogRingRecord;
+
+#endif
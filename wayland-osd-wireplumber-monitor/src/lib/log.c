@@ -20,9 +20,22 @@
  * IN THE SOFTWARE.
  */
 
+#define _GNU_SOURCE
 #include "log.h"
+#include "log-ring.h"
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/uio.h>
+#include <unistd.h>
 
 #define MAX_CALLBACKS 32
+#define ASYNC_RING_RECORDS 256
+#define ASYNC_LINE_MAX 512
+#define ASYNC_MAX_BATCH 64
 
 typedef struct {
   log_LogFn fn;
@@ -50,34 +63,272 @@ static const char *level_colors[] = {
 #endif
 
 
+/* One formatted message queued for the flusher thread. */
+typedef struct {
+  int fd;
+  unsigned short len;
+  char msg[ASYNC_LINE_MAX];
+} AsyncRecord;
+
+static struct {
+  AsyncRecord records[ASYNC_RING_RECORDS];
+  size_t head;          /* consumed by the flusher */
+  size_t tail;          /* produced by log_log() */
+  size_t dropped;       /* messages lost to a full ring */
+  bool enabled;
+  bool running;
+  bool deferred;        /* drained by log_pump() instead of a thread */
+  void (*notify_fn)(void *udata);
+  void *notify_udata;
+  pthread_t thread;
+  pthread_mutex_t mutex;
+  pthread_cond_t ready;
+  pthread_cond_t drained;
+} A = {
+  .mutex = PTHREAD_MUTEX_INITIALIZER,
+  .ready = PTHREAD_COND_INITIALIZER,
+  .drained = PTHREAD_COND_INITIALIZER,
+};
+
+
+static void async_enqueue(int fd, const char *data, size_t len) {
+  if (len > ASYNC_LINE_MAX) { len = ASYNC_LINE_MAX; }
+
+  pthread_mutex_lock(&A.mutex);
+  size_t next = (A.tail + 1) % ASYNC_RING_RECORDS;
+  if (next == A.head) {
+    /* Ring full: dropping beats blocking the event path */
+    A.dropped++;
+    pthread_mutex_unlock(&A.mutex);
+    return;
+  }
+  bool was_empty = A.head == A.tail;
+  AsyncRecord *rec = &A.records[A.tail];
+  rec->fd = fd;
+  rec->len = (unsigned short)len;
+  memcpy(rec->msg, data, len);
+  A.tail = next;
+  pthread_cond_signal(&A.ready);
+  pthread_mutex_unlock(&A.mutex);
+
+  /* In deferred mode, tell the application the queue went non-empty so
+   * it can schedule a pump; called outside the lock. */
+  if (A.deferred && was_empty && A.notify_fn) {
+    A.notify_fn(A.notify_udata);
+  }
+}
+
+
+static void *async_flusher(void *arg) {
+  (void)arg;
+  struct iovec iov[ASYNC_MAX_BATCH];
+
+  pthread_mutex_lock(&A.mutex);
+  for (;;) {
+    while (A.head == A.tail && A.running) {
+      pthread_cond_wait(&A.ready, &A.mutex);
+    }
+    if (A.head == A.tail && !A.running) { break; }
+
+    /* Batch consecutive records sharing a target fd into one writev.
+     * Producers never touch [head, tail), so the payload can be written
+     * without holding the lock. */
+    int fd = A.records[A.head].fd;
+    int count = 0;
+    size_t idx = A.head;
+    while (idx != A.tail && count < ASYNC_MAX_BATCH && A.records[idx].fd == fd) {
+      iov[count].iov_base = A.records[idx].msg;
+      iov[count].iov_len = A.records[idx].len;
+      count++;
+      idx = (idx + 1) % ASYNC_RING_RECORDS;
+    }
+    size_t dropped = A.dropped;
+    A.dropped = 0;
+    pthread_mutex_unlock(&A.mutex);
+
+    ssize_t written = writev(fd, iov, count);
+    (void)written;
+    if (dropped > 0) {
+      dprintf(fd, "... dropped %zu log messages\n", dropped);
+    }
+
+    pthread_mutex_lock(&A.mutex);
+    A.head = idx;
+    if (A.head == A.tail) {
+      pthread_cond_broadcast(&A.drained);
+    }
+  }
+  pthread_mutex_unlock(&A.mutex);
+  return NULL;
+}
+
+
+size_t log_pump(size_t max_records) {
+  struct iovec iov[ASYNC_MAX_BATCH];
+  size_t pumped = 0;
+
+  pthread_mutex_lock(&A.mutex);
+  while (A.head != A.tail && pumped < max_records) {
+    /* Same fd-batched writev as the flusher thread: producers never
+     * touch [head, tail), so the payload is written outside the lock. */
+    int fd = A.records[A.head].fd;
+    size_t count = 0;
+    size_t idx = A.head;
+    while (idx != A.tail && count < ASYNC_MAX_BATCH &&
+           pumped + count < max_records && A.records[idx].fd == fd) {
+      iov[count].iov_base = A.records[idx].msg;
+      iov[count].iov_len = A.records[idx].len;
+      count++;
+      idx = (idx + 1) % ASYNC_RING_RECORDS;
+    }
+    size_t dropped = A.dropped;
+    A.dropped = 0;
+    pthread_mutex_unlock(&A.mutex);
+
+    ssize_t written = writev(fd, iov, (int)count);
+    (void)written;
+    if (dropped > 0) {
+      dprintf(fd, "... dropped %zu log messages\n", dropped);
+    }
+
+    pthread_mutex_lock(&A.mutex);
+    A.head = idx;
+    pumped += count;
+  }
+  size_t remaining =
+    (A.tail + ASYNC_RING_RECORDS - A.head) % ASYNC_RING_RECORDS;
+  pthread_mutex_unlock(&A.mutex);
+  return remaining;
+}
+
+
+void log_flush(void) {
+  if (A.deferred) {
+    while (log_pump(ASYNC_RING_RECORDS) > 0) { }
+    return;
+  }
+  pthread_mutex_lock(&A.mutex);
+  if (A.running) {
+    pthread_cond_signal(&A.ready);
+    while (A.head != A.tail) {
+      pthread_cond_wait(&A.drained, &A.mutex);
+    }
+  }
+  pthread_mutex_unlock(&A.mutex);
+}
+
+
+void log_set_async(bool enable) {
+  if (enable == A.enabled) { return; }
+  if (enable) {
+    A.running = true;
+    if (pthread_create(&A.thread, NULL, async_flusher, NULL) != 0) {
+      A.running = false;
+      return;
+    }
+    A.enabled = true;
+    atexit(log_flush);
+  } else {
+    pthread_mutex_lock(&A.mutex);
+    A.enabled = false;
+    A.running = false;
+    pthread_cond_signal(&A.ready);
+    pthread_mutex_unlock(&A.mutex);
+    pthread_join(A.thread, NULL);
+  }
+}
+
+
+void log_set_deferred(bool enable) {
+  if (enable == A.deferred) { return; }
+  if (enable) {
+    A.deferred = true;
+    A.enabled = true;
+    atexit(log_flush);
+  } else {
+    log_flush();
+    A.enabled = false;
+    A.deferred = false;
+  }
+}
+
+
+void log_set_pump_notify(void (*fn)(void *udata), void *udata) {
+  pthread_mutex_lock(&A.mutex);
+  A.notify_fn = fn;
+  A.notify_udata = udata;
+  pthread_mutex_unlock(&A.mutex);
+}
+
+
+/* Append the formatted message and a newline to the prefix already in
+ * line, returning the total length (clamped to the buffer). */
+static size_t finish_line(log_Event *ev, char *line, size_t size, int prefix_len) {
+  size_t len = prefix_len > 0 ? (size_t)prefix_len : 0;
+  if (len >= size) { len = size - 1; }
+  int n = vsnprintf(line + len, size - len, ev->fmt, ev->ap);
+  if (n > 0) { len += (size_t)n; }
+  if (len > size - 2) { len = size - 2; }
+  line[len++] = '\n';
+  return len;
+}
+
+
+static void emit_line(log_Event *ev, char *line, size_t len) {
+  FILE *stream = ev->udata;
+  if (A.enabled) {
+    async_enqueue(fileno(stream), line, len);
+    if (ev->level == LOG_FATAL) { log_flush(); }
+  } else {
+    fwrite(line, 1, len, stream);
+    fflush(stream);
+  }
+}
+
+
+/* Timestamps are cached per epoch second: localtime() takes a
+ * process-wide lock in glibc and strftime() isn't cheap either, so under
+ * an event storm the common case should be reusing prebuilt strings. */
+static struct {
+  time_t second;
+  struct tm tm;
+  char clock[16];     /* "%H:%M:%S" */
+  char datetime[64];  /* "%Y-%m-%d %H:%M:%S" */
+} T;
+
+
+static void refresh_time_cache(void) {
+  time_t t = time(NULL);
+  if (t == T.second) { return; }
+  T.second = t;
+  localtime_r(&t, &T.tm);
+  T.clock[strftime(T.clock, sizeof(T.clock), "%H:%M:%S", &T.tm)] = '\0';
+  T.datetime[strftime(T.datetime, sizeof(T.datetime), "%Y-%m-%d %H:%M:%S", &T.tm)] = '\0';
+}
+
+
 static void stdout_callback(log_Event *ev) {
-  char buf[16];
-  buf[strftime(buf, sizeof(buf), "%H:%M:%S", ev->time)] = '\0';
+  char line[ASYNC_LINE_MAX];
 #ifdef LOG_USE_COLOR
-  fprintf(
-    ev->udata, "%s %s%-5s\x1b[0m \x1b[90m%s:%d:\x1b[0m ",
-    buf, level_colors[ev->level], level_strings[ev->level],
+  int n = snprintf(
+    line, sizeof(line), "%s %s%-5s\x1b[0m \x1b[90m%s:%d:\x1b[0m ",
+    T.clock, level_colors[ev->level], level_strings[ev->level],
     ev->file, ev->line);
 #else
-  fprintf(
-    ev->udata, "%s %-5s %s:%d: ",
-    buf, level_strings[ev->level], ev->file, ev->line);
+  int n = snprintf(
+    line, sizeof(line), "%s %-5s %s:%d: ",
+    T.clock, level_strings[ev->level], ev->file, ev->line);
 #endif
-  vfprintf(ev->udata, ev->fmt, ev->ap);
-  fprintf(ev->udata, "\n");
-  fflush(ev->udata);
+  emit_line(ev, line, finish_line(ev, line, sizeof(line), n));
 }
 
 
 static void file_callback(log_Event *ev) {
-  char buf[64];
-  buf[strftime(buf, sizeof(buf), "%Y-%m-%d %H:%M:%S", ev->time)] = '\0';
-  fprintf(
-    ev->udata, "%s %-5s %s:%d: ",
-    buf, level_strings[ev->level], ev->file, ev->line);
-  vfprintf(ev->udata, ev->fmt, ev->ap);
-  fprintf(ev->udata, "\n");
-  fflush(ev->udata);
+  char line[ASYNC_LINE_MAX];
+  int n = snprintf(
+    line, sizeof(line), "%s %-5s %s:%d: ",
+    T.datetime, level_strings[ev->level], ev->file, ev->line);
+  emit_line(ev, line, finish_line(ev, line, sizeof(line), n));
 }
 
 
@@ -128,10 +379,91 @@ int log_add_fp(FILE *fp, int level) {
 }
 
 
+typedef struct {
+  LogRingHeader *header;
+  LogRingRecord *records;
+  size_t map_size;
+} LogRing;
+
+
+static void ring_callback(log_Event *ev) {
+  LogRing *ring = ev->udata;
+  LogRingRecord *rec =
+    &ring->records[ring->header->next_index % ring->header->record_count];
+
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  rec->mono_ns = (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+  rec->line = (uint32_t)ev->line;
+  rec->level = (uint8_t)ev->level;
+
+  size_t file_len = strlen(ev->file);
+  if (file_len > LOG_RING_TEXT_MAX / 2) { file_len = LOG_RING_TEXT_MAX / 2; }
+  memcpy(rec->text, ev->file, file_len);
+  rec->file_len = (uint8_t)file_len;
+
+  int n = vsnprintf(rec->text + file_len, LOG_RING_TEXT_MAX - file_len,
+                    ev->fmt, ev->ap);
+  size_t msg_len = n > 0 ? (size_t)n : 0;
+  if (msg_len > LOG_RING_TEXT_MAX - file_len - 1) {
+    msg_len = LOG_RING_TEXT_MAX - file_len - 1;
+  }
+  rec->msg_len = (uint16_t)msg_len;
+
+  /* Publish only after the record is complete so the decoder never sees
+   * a half-written slot as valid. The kernel writes pages back lazily;
+   * no explicit msync on the hot path. */
+  ring->header->next_index++;
+}
+
+
+int log_add_ringfile(const char *path, int level, size_t size) {
+  if (size < sizeof(LogRingHeader) + 16 * sizeof(LogRingRecord)) {
+    return -1;
+  }
+  uint32_t record_count =
+    (uint32_t)((size - sizeof(LogRingHeader)) / sizeof(LogRingRecord));
+  size_t map_size = sizeof(LogRingHeader) + record_count * sizeof(LogRingRecord);
+
+  int fd = open(path, O_RDWR | O_CREAT, 0644);
+  if (fd == -1) { return -1; }
+  if (ftruncate(fd, (off_t)map_size) == -1) {
+    close(fd);
+    return -1;
+  }
+
+  void *map = mmap(NULL, map_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (map == MAP_FAILED) { return -1; }
+
+  LogRing *ring = malloc(sizeof(LogRing));
+  if (!ring) {
+    munmap(map, map_size);
+    return -1;
+  }
+  ring->header = map;
+  ring->records = (LogRingRecord *)((char *)map + sizeof(LogRingHeader));
+  ring->map_size = map_size;
+
+  /* Keep appending to an existing compatible ring across restarts,
+   * otherwise (re)initialize the header */
+  if (memcmp(ring->header->magic, LOG_RING_MAGIC, sizeof(ring->header->magic)) != 0 ||
+      ring->header->version != LOG_RING_VERSION ||
+      ring->header->record_count != record_count) {
+    memcpy(ring->header->magic, LOG_RING_MAGIC, sizeof(ring->header->magic));
+    ring->header->version = LOG_RING_VERSION;
+    ring->header->record_count = record_count;
+    ring->header->next_index = 0;
+  }
+
+  return log_add_callback(ring_callback, ring, level);
+}
+
+
 static void init_event(log_Event *ev, void *udata) {
   if (!ev->time) {
-    time_t t = time(NULL);
-    ev->time = localtime(&t);
+    refresh_time_cache();
+    ev->time = &T.tm;
   }
   ev->udata = udata;
 }
@@ -28,21 +28,82 @@ typedef struct {
 typedef void (*log_LogFn)(log_Event *ev);
 typedef void (*log_LockFn)(bool lock, void *udata);
 
-enum { LOG_TRACE, LOG_DEBUG, LOG_INFO, LOG_WARN, LOG_ERROR, LOG_FATAL };
+/* Levels are plain defines (not an enum) so they can be compared in
+ * preprocessor conditionals below. */
+#define LOG_TRACE 0
+#define LOG_DEBUG 1
+#define LOG_INFO  2
+#define LOG_WARN  3
+#define LOG_ERROR 4
+#define LOG_FATAL 5
 
+/* Calls below LOG_MIN_LEVEL compile to nothing, including their argument
+ * evaluation, so hot paths carry zero logging cost in production builds.
+ * Override from the build, e.g. `defines += LOG_MIN_LEVEL=LOG_INFO`. */
+#ifndef LOG_MIN_LEVEL
+#define LOG_MIN_LEVEL LOG_TRACE
+#endif
+
+#if LOG_MIN_LEVEL <= LOG_TRACE
 #define log_trace(...) log_log(LOG_TRACE, __FILE__, __LINE__, __VA_ARGS__)
+#else
+#define log_trace(...) ((void)0)
+#endif
+
+#if LOG_MIN_LEVEL <= LOG_DEBUG
 #define log_debug(...) log_log(LOG_DEBUG, __FILE__, __LINE__, __VA_ARGS__)
+#else
+#define log_debug(...) ((void)0)
+#endif
+
+#if LOG_MIN_LEVEL <= LOG_INFO
 #define log_info(...)  log_log(LOG_INFO,  __FILE__, __LINE__, __VA_ARGS__)
+#else
+#define log_info(...)  ((void)0)
+#endif
+
+#if LOG_MIN_LEVEL <= LOG_WARN
 #define log_warn(...)  log_log(LOG_WARN,  __FILE__, __LINE__, __VA_ARGS__)
+#else
+#define log_warn(...)  ((void)0)
+#endif
+
+#if LOG_MIN_LEVEL <= LOG_ERROR
 #define log_error(...) log_log(LOG_ERROR, __FILE__, __LINE__, __VA_ARGS__)
+#else
+#define log_error(...) ((void)0)
+#endif
+
 #define log_fatal(...) log_log(LOG_FATAL, __FILE__, __LINE__, __VA_ARGS__)
 
 const char* log_level_string(int level);
 void log_set_lock(log_LockFn fn, void *udata);
 void log_set_level(int level);
 void log_set_quiet(bool enable);
+/* Route sink output through a fixed-size ring drained by a background
+ * thread, so logging on a hot path costs a memcpy instead of a blocking
+ * fflush. FATAL messages are flushed synchronously. */
+void log_set_async(bool enable);
+/* Like async, but with no flusher thread: the application drains the
+ * ring itself via log_pump(), e.g. from a low-priority main-loop source,
+ * so log emission runs strictly after event-path work. */
+void log_set_deferred(bool enable);
+/* Drain up to max_records queued messages to their fds; returns how many
+ * remain so the caller can reschedule itself. */
+size_t log_pump(size_t max_records);
+/* Called (without the ring lock held) when the queue transitions from
+ * empty to non-empty in deferred mode, so the application can schedule a
+ * pump. */
+void log_set_pump_notify(void (*fn)(void *udata), void *udata);
+/* Block until all queued messages have reached their sinks; in deferred
+ * mode the calling thread pumps the ring itself. */
+void log_flush(void);
 int log_add_callback(log_LogFn fn, void *udata, int level);
 int log_add_fp(FILE *fp, int level);
+/* Flight-recorder sink: compact binary records written into a
+ * memory-mapped ring file of roughly `size` bytes. Always-on tracing
+ * with bounded disk usage; decode with the logdump tool. */
+int log_add_ringfile(const char *path, int level, size_t size);
 
 void log_log(int level, const char *file, int line, const char *fmt, ...);
 
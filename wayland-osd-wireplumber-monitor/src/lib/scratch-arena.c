@@ -0,0 +1,57 @@
+#define _GNU_SOURCE
+#include "scratch-arena.h"
+
+#include <stdalign.h>
+#include <stdlib.h>
+#include <string.h>
+
+struct ScratchChunk {
+    ScratchChunk *next;
+    size_t used;
+    size_t size;
+    alignas(max_align_t) char data[];
+};
+
+void scratch_arena_init(ScratchArena *arena, size_t chunk_size) {
+    arena->chunks = NULL;
+    arena->chunk_size = chunk_size;
+}
+
+void *scratch_arena_alloc(ScratchArena *arena, size_t size) {
+    // Round up so every returned pointer keeps max_align_t alignment
+    size = (size + alignof(max_align_t) - 1) & ~(alignof(max_align_t) - 1);
+
+    ScratchChunk *chunk = arena->chunks;
+    if (chunk == NULL || chunk->size - chunk->used < size) {
+        size_t data_size = size > arena->chunk_size ? size : arena->chunk_size;
+        chunk = malloc(sizeof(ScratchChunk) + data_size);
+        if (chunk == NULL)
+            return NULL;
+        chunk->next = arena->chunks;
+        chunk->used = 0;
+        chunk->size = data_size;
+        arena->chunks = chunk;
+    }
+
+    void *ptr = chunk->data + chunk->used;
+    chunk->used += size;
+    return ptr;
+}
+
+char *scratch_arena_strdup(ScratchArena *arena, const char *s) {
+    size_t len = strlen(s) + 1;
+    char *copy = scratch_arena_alloc(arena, len);
+    if (copy != NULL)
+        memcpy(copy, s, len);
+    return copy;
+}
+
+void scratch_arena_reset(ScratchArena *arena) {
+    ScratchChunk *chunk = arena->chunks;
+    while (chunk != NULL) {
+        ScratchChunk *next = chunk->next;
+        free(chunk);
+        chunk = next;
+    }
+    arena->chunks = NULL;
+}
@@ -0,0 +1,30 @@
+#ifndef SCRATCH_ARENA_H
+#define SCRATCH_ARENA_H
+
+#include <stddef.h>
+
+// Bump allocator for small objects that share one lifetime. Allocations
+// are a pointer bump within the current chunk; individual frees do not
+// exist, the whole arena resets at once. Used for the per-connection
+// node caches, so steady-state event handling never calls malloc and a
+// reconnect releases everything in a handful of free()s.
+
+typedef struct ScratchChunk ScratchChunk;
+
+typedef struct {
+    ScratchChunk *chunks;  // most recently added first
+    size_t chunk_size;
+} ScratchArena;
+
+void scratch_arena_init(ScratchArena *arena, size_t chunk_size);
+
+// Returns max_align_t-aligned memory, or NULL if a fresh chunk could not
+// be allocated. Requests larger than chunk_size get their own chunk.
+void *scratch_arena_alloc(ScratchArena *arena, size_t size);
+
+char *scratch_arena_strdup(ScratchArena *arena, const char *s);
+
+// Free every chunk; the arena stays initialized and usable.
+void scratch_arena_reset(ScratchArena *arena);
+
+#endif
@@ -0,0 +1,98 @@
+#define _GNU_SOURCE
+#include "stats.h"
+#include "alloc-count.h"
+#include "log.h"
+
+#include <stdio.h>
+#include <time.h>
+
+uint64_t monotonic_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+void histogram_record(LatencyHistogram *hist, uint64_t ns) {
+    int bucket = 0;
+    for (uint64_t v = ns; v >>= 1;)
+        bucket++; // floor(log2(ns)), 0 for ns <= 1
+    if (bucket >= LATENCY_BUCKET_COUNT)
+        bucket = LATENCY_BUCKET_COUNT - 1;
+
+    hist->buckets[bucket]++;
+    hist->count++;
+    hist->sum_ns += ns;
+    if (ns > hist->max_ns)
+        hist->max_ns = ns;
+}
+
+uint64_t histogram_percentile_ns(const LatencyHistogram *hist, double percentile) {
+    if (hist->count == 0)
+        return 0;
+
+    uint64_t rank = (uint64_t)((double)hist->count * percentile / 100.0);
+    if (rank >= hist->count)
+        rank = hist->count - 1;
+
+    uint64_t seen = 0;
+    for (int i = 0; i < LATENCY_BUCKET_COUNT; i++) {
+        seen += hist->buckets[i];
+        if (seen > rank)
+            return 1ull << (i + 1); // bucket upper bound
+    }
+    return hist->max_ns;
+}
+
+const char *stats_format_ns(uint64_t ns, char *buf, size_t size) {
+    if (ns < 1000)
+        snprintf(buf, size, "%luns", (unsigned long)ns);
+    else if (ns < 1000000)
+        snprintf(buf, size, "%.1fus", (double)ns / 1000.0);
+    else if (ns < 1000000000)
+        snprintf(buf, size, "%.1fms", (double)ns / 1000000.0);
+    else
+        snprintf(buf, size, "%.1fs", (double)ns / 1000000000.0);
+    return buf;
+}
+
+static void histogram_log(const LatencyHistogram *hist, const char *name) {
+    if (hist->count == 0) {
+        log_info("stats: %s: no samples", name);
+        return;
+    }
+
+    char avg[16], p50[16], p99[16], max[16];
+    stats_format_ns(hist->sum_ns / hist->count, avg, sizeof(avg));
+    stats_format_ns(histogram_percentile_ns(hist, 50.0), p50, sizeof(p50));
+    stats_format_ns(histogram_percentile_ns(hist, 99.0), p99, sizeof(p99));
+    stats_format_ns(hist->max_ns, max, sizeof(max));
+    log_info("stats: %s: n=%lu avg=%s p50<=%s p99<=%s max=%s", name,
+             (unsigned long)hist->count, avg, p50, p99, max);
+
+    for (int i = 0; i < LATENCY_BUCKET_COUNT; i++) {
+        if (hist->buckets[i] == 0)
+            continue;
+        char lo[16], hi[16];
+        stats_format_ns(1ull << i, lo, sizeof(lo));
+        stats_format_ns(1ull << (i + 1), hi, sizeof(hi));
+        log_info("stats: %s:   [%s, %s) %lu", name, lo, hi,
+                 (unsigned long)hist->buckets[i]);
+    }
+}
+
+void stats_log(const Stats *stats) {
+    log_info("stats: events seen=%lu deduped=%lu coalesced=%lu "
+             "clients spawned=%lu messages sent=%lu",
+             (unsigned long)stats->events_seen,
+             (unsigned long)stats->events_deduped,
+             (unsigned long)stats->events_coalesced,
+             (unsigned long)stats->clients_spawned,
+             (unsigned long)stats->messages_sent);
+    if (alloc_count_active()) {
+        log_info("stats: heap: allocating events=%lu allocations=%lu",
+                 (unsigned long)stats->events_allocating,
+                 (unsigned long)stats->event_allocs);
+    }
+    histogram_log(&stats->signal_to_update, "signal-to-update");
+    histogram_log(&stats->signal_to_dispatch, "signal-to-dispatch");
+}
@@ -0,0 +1,50 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Log2-spaced latency buckets: bucket i counts samples in [2^i, 2^(i+1))
+// nanoseconds. 40 buckets cover single nanoseconds up to ~18 minutes.
+#define LATENCY_BUCKET_COUNT 40
+
+typedef struct {
+    uint64_t buckets[LATENCY_BUCKET_COUNT];
+    uint64_t count;
+    uint64_t sum_ns;
+    uint64_t max_ns;
+} LatencyHistogram;
+
+// Pipeline instrumentation: how long the path from WirePlumber signal
+// receipt to client dispatch takes, and where events fall out of it.
+typedef struct {
+    LatencyHistogram signal_to_update;   // mixer signal -> volume read
+    LatencyHistogram signal_to_dispatch; // mixer signal -> message delivered
+    uint64_t events_seen;
+    uint64_t events_deduped;
+    uint64_t events_coalesced;
+    uint64_t clients_spawned;
+    uint64_t messages_sent;
+    // Heap traffic during event handling, sampled from the ALLOC_COUNT
+    // interposer (see alloc-count.h); stays zero in normal builds
+    uint64_t events_allocating;
+    uint64_t event_allocs;
+} Stats;
+
+uint64_t monotonic_ns(void);
+
+void histogram_record(LatencyHistogram *hist, uint64_t ns);
+
+// Upper bound (in ns) of the bucket containing the given percentile,
+// e.g. 50.0 or 99.0. Returns 0 for an empty histogram.
+uint64_t histogram_percentile_ns(const LatencyHistogram *hist, double percentile);
+
+// Render ns as a short human-readable value ("730ns", "4.2us", "1.8ms")
+// into buf, returning buf.
+const char *stats_format_ns(uint64_t ns, char *buf, size_t size);
+
+// Emit one summary line per histogram plus all counters through the
+// configured log sinks.
+void stats_log(const Stats *stats);
+
+#endif
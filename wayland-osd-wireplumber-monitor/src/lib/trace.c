@@ -0,0 +1,80 @@
+#define _GNU_SOURCE
+#include "trace.h"
+
+#include <string.h>
+#include <sys/stat.h>
+
+bool trace_writer_open(TraceWriter *writer, const char *path) {
+    writer->fp = fopen(path, "ab");
+    if (writer->fp == NULL)
+        return false;
+
+    struct stat st;
+    if (fstat(fileno(writer->fp), &st) == 0 && st.st_size == 0) {
+        TraceHeader header = {0};
+        memcpy(header.magic, TRACE_MAGIC, sizeof(header.magic));
+        header.version = TRACE_VERSION;
+        fwrite(&header, sizeof(header), 1, writer->fp);
+    }
+    return true;
+}
+
+void trace_writer_record(TraceWriter *writer, const TraceRecord *record,
+                         const char *name) {
+    if (writer->fp == NULL)
+        return;
+    fwrite(record, sizeof(*record), 1, writer->fp);
+    if (record->name_len > 0 && name != NULL)
+        fwrite(name, record->name_len, 1, writer->fp);
+}
+
+void trace_writer_close(TraceWriter *writer) {
+    if (writer->fp != NULL) {
+        fclose(writer->fp);
+        writer->fp = NULL;
+    }
+}
+
+bool trace_reader_open(TraceReader *reader, const char *path) {
+    reader->fp = fopen(path, "rb");
+    if (reader->fp == NULL)
+        return false;
+
+    TraceHeader header;
+    if (fread(&header, sizeof(header), 1, reader->fp) != 1 ||
+        memcmp(header.magic, TRACE_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != TRACE_VERSION) {
+        fclose(reader->fp);
+        reader->fp = NULL;
+        return false;
+    }
+    return true;
+}
+
+int trace_reader_next(TraceReader *reader, TraceRecord *record, char *name,
+                      size_t name_size) {
+    if (fread(record, sizeof(*record), 1, reader->fp) != 1)
+        return feof(reader->fp) ? 0 : -1;
+
+    name[0] = '\0';
+    if (record->name_len == 0)
+        return 1;
+
+    char buf[1024];
+    if (record->name_len > sizeof(buf))
+        return -1;
+    if (fread(buf, record->name_len, 1, reader->fp) != 1)
+        return -1;
+
+    size_t copy = record->name_len < name_size - 1 ? record->name_len : name_size - 1;
+    memcpy(name, buf, copy);
+    name[copy] = '\0';
+    return 1;
+}
+
+void trace_reader_close(TraceReader *reader) {
+    if (reader->fp != NULL) {
+        fclose(reader->fp);
+        reader->fp = NULL;
+    }
+}
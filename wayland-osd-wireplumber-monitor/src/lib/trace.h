@@ -0,0 +1,70 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+// On-disk event trace format (--record / --replay): a fixed header
+// followed by fixed-size records, each optionally trailed by name_len
+// bytes of node name. Timestamps are CLOCK_MONOTONIC nanoseconds from
+// the recording process, so replay preserves inter-event spacing.
+
+#define TRACE_MAGIC "WOSDTRAC"
+#define TRACE_VERSION 1
+
+enum {
+    TRACE_EVENT_VOLUME = 1,       // a mixer volume/mute update
+    TRACE_EVENT_DEFAULT_NODE = 2, // the default node changed
+};
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t reserved;
+} TraceHeader;
+
+typedef struct {
+    uint64_t mono_ns;
+    uint8_t type;     // TRACE_EVENT_*
+    uint8_t endpoint; // ENDPOINT_SINK / ENDPOINT_SOURCE index
+    uint8_t muted;
+    uint8_t reserved;
+    uint32_t node_id;
+    double volume;
+    double step;
+    uint16_t name_len; // bytes of node name following this record
+    uint16_t reserved2;
+    uint32_t reserved3;
+} TraceRecord;
+
+typedef struct {
+    FILE *fp;
+} TraceWriter;
+
+typedef struct {
+    FILE *fp;
+} TraceReader;
+
+// Open path for appending; writes the header if the file is new/empty.
+bool trace_writer_open(TraceWriter *writer, const char *path);
+
+// Append one record plus its optional name payload (NULL for none).
+// Buffered stdio keeps the per-event cost to a memcpy.
+void trace_writer_record(TraceWriter *writer, const TraceRecord *record,
+                         const char *name);
+
+void trace_writer_close(TraceWriter *writer);
+
+bool trace_reader_open(TraceReader *reader, const char *path);
+
+// Read the next record into *record and its name into name (always
+// NUL-terminated, truncated to name_size). Returns 1 on success, 0 at
+// end of trace, -1 on a malformed record.
+int trace_reader_next(TraceReader *reader, TraceRecord *record, char *name,
+                      size_t name_size);
+
+void trace_reader_close(TraceReader *reader);
+
+#endif
@@ -0,0 +1,39 @@
+#define _GNU_SOURCE
+#include "volume-curve.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+bool volume_curve_parse(const char *name, double *exponent) {
+    if (strcmp(name, "cubic") == 0) {
+        *exponent = 1.0 / 3.0;
+        return true;
+    }
+    if (strcmp(name, "linear") == 0) {
+        *exponent = 1.0;
+        return true;
+    }
+
+    char *end = NULL;
+    double value = strtod(name, &end);
+    if (end == name || *end != '\0' || value <= 0.0)
+        return false;
+    *exponent = value;
+    return true;
+}
+
+void volume_curve_init(VolumeCurve *curve, double exponent) {
+    curve->exponent = exponent;
+    for (int i = 0; i < VOLUME_CURVE_STEPS; i++) {
+        // Evaluate at the center of each quantization step
+        double raw = ((double)i + 0.5) * (VOLUME_CURVE_RAW_MAX / VOLUME_CURVE_STEPS);
+        curve->percent[i] = (int)lround(pow(raw, exponent) * 100.0);
+    }
+}
+
+int volume_curve_percent_exact(const VolumeCurve *curve, double raw) {
+    if (raw <= 0.0)
+        return 0;
+    return (int)lround(pow(raw, curve->exponent) * 100.0);
+}
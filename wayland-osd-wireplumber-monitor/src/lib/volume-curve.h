@@ -0,0 +1,49 @@
+#ifndef VOLUME_CURVE_H
+#define VOLUME_CURVE_H
+
+#include <stdbool.h>
+
+// Raw-volume to OSD-percent conversion, precomputed at startup into a
+// lookup table so the per-event cost is one array load instead of a libm
+// call. The table quantizes raw volume over [0, VOLUME_CURVE_RAW_MAX),
+// which covers overamplified levels well past 100%.
+
+#define VOLUME_CURVE_STEPS 2048
+#define VOLUME_CURVE_RAW_MAX 2.0
+
+// Sublinear curves have unbounded slope at zero, so the lowest buckets
+// each span several output percents (for cubic, bucket 0 alone covers
+// 0-10%). Below this index the lookup falls back to the exact pow()
+// the table was built from; low volumes are a cold path, and this keeps
+// the result within one percent everywhere.
+#define VOLUME_CURVE_EXACT_STEPS 32
+
+typedef struct {
+    int percent[VOLUME_CURVE_STEPS];
+    double exponent;
+} VolumeCurve;
+
+// Map a curve name to its exponent: "cubic" (1/3, the PipeWire default),
+// "linear" (1), or a custom positive exponent such as "0.5". Returns
+// false for anything else.
+bool volume_curve_parse(const char *name, double *exponent);
+
+// Fill the table with percent = round(raw^exponent * 100).
+void volume_curve_init(VolumeCurve *curve, double exponent);
+
+// round(raw^exponent * 100) computed directly; the slow path behind the
+// table, kept in the .c so the header stays libm-free.
+int volume_curve_percent_exact(const VolumeCurve *curve, double raw);
+
+static inline int volume_curve_percent(const VolumeCurve *curve, double raw) {
+    if (raw <= 0.0)
+        return 0;
+    int index = (int)(raw * (VOLUME_CURVE_STEPS / VOLUME_CURVE_RAW_MAX));
+    if (index < VOLUME_CURVE_EXACT_STEPS)
+        return volume_curve_percent_exact(curve, raw);
+    if (index >= VOLUME_CURVE_STEPS)
+        index = VOLUME_CURVE_STEPS - 1;
+    return curve->percent[index];
+}
+
+#endif
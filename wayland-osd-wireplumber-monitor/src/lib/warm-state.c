@@ -0,0 +1,52 @@
+#define _GNU_SOURCE
+#include "warm-state.h"
+
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+bool warm_state_open(WarmState *state, const char *path, uint32_t slot_count) {
+    size_t map_size =
+        sizeof(WarmStateHeader) + slot_count * sizeof(WarmStateSlot);
+
+    int fd = open(path, O_RDWR | O_CREAT, 0600);
+    if (fd == -1)
+        return false;
+    if (ftruncate(fd, (off_t)map_size) == -1) {
+        close(fd);
+        return false;
+    }
+
+    void *map = mmap(NULL, map_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED)
+        return false;
+
+    state->header = map;
+    state->slots = (WarmStateSlot *)((char *)map + sizeof(WarmStateHeader));
+    state->map_size = map_size;
+
+    // Keep state from a previous run only if the layout matches,
+    // otherwise start from an empty file
+    if (memcmp(state->header->magic, WARM_STATE_MAGIC,
+               sizeof(state->header->magic)) != 0 ||
+        state->header->version != WARM_STATE_VERSION ||
+        state->header->slot_count != slot_count) {
+        memset(map, 0, map_size);
+        memcpy(state->header->magic, WARM_STATE_MAGIC,
+               sizeof(state->header->magic));
+        state->header->version = WARM_STATE_VERSION;
+        state->header->slot_count = slot_count;
+    }
+
+    return true;
+}
+
+void warm_state_close(WarmState *state) {
+    if (state->header == NULL)
+        return;
+    munmap(state->header, state->map_size);
+    state->header = NULL;
+    state->slots = NULL;
+}
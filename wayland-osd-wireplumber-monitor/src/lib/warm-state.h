@@ -0,0 +1,52 @@
+#ifndef WARM_STATE_H
+#define WARM_STATE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Warm-restart persistence of the per-endpoint hot state: default node
+// identity plus the last dispatched volume/mute. The file is a tiny
+// memory-mapped struct updated by plain stores on the dispatch path, so
+// persistence costs no syscalls; the kernel writes the page back lazily,
+// like the log ring sink. A restarted monitor restores this before the
+// WirePlumber handshake completes, so it can serve its first event
+// without waiting for the initial default-node queries.
+
+#define WARM_STATE_MAGIC "WOSDSTAT"
+#define WARM_STATE_VERSION 1
+#define WARM_STATE_NAME_MAX 116
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t slot_count;
+} WarmStateHeader;
+
+typedef struct {
+    uint32_t node_id;
+    uint8_t has_state;
+    uint8_t muted;
+    uint8_t reserved[2];
+    int32_t volume;                       // OSD percent, post volume curve
+    char node_name[WARM_STATE_NAME_MAX];  // NUL-terminated, may be truncated
+} WarmStateSlot;
+
+typedef struct {
+    WarmStateHeader *header;
+    WarmStateSlot *slots;
+    size_t map_size;
+} WarmState;
+
+// Map the state file at path, creating it if needed. An incompatible or
+// freshly created file comes back with all slots zeroed. Returns false on
+// I/O failure, in which case the caller just runs without persistence.
+bool warm_state_open(WarmState *state, const char *path, uint32_t slot_count);
+
+void warm_state_close(WarmState *state);
+
+static inline WarmStateSlot *warm_state_slot(WarmState *state, uint32_t index) {
+    return &state->slots[index];
+}
+
+#endif
@@ -1,13 +1,31 @@
 #define _GNU_SOURCE
+#include "lib/alloc-count.h"
+#include "lib/device-map.h"
 #include "lib/log.h"
+#include "lib/scratch-arena.h"
+#include "lib/stats.h"
+#include "lib/trace.h"
+#include "lib/volume-curve.h"
+#include "lib/warm-state.h"
 #include <stdbool.h>
 #include <stdio.h>
 #include <glib.h>
-#include <math.h>
+#include <glib-unix.h>
+#include <gio/gio.h>
 #include <wireplumber-0.5/wp/wp.h>
 #include <stdlib.h>
 #include <unistd.h>
 #include <argp.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <spawn.h>
+#include <string.h>
+#include <linux/input.h>
+#include <malloc.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
 
 const char *argp_program_version = "wayland-osd-wireplumber-monitor 1.0";
 const char *argp_program_bug_address = "https://github.com/ErikReider/wayland-osd";
@@ -15,139 +33,208 @@ const char *argp_program_bug_address = "https://github.com/ErikReider/wayland-os
 static char doc[] = "Wayland OSD Wireplumber Monitor -- A monitor for audio volume changes using wireplumber";
 static char args_doc[] = "[CLIENT_PATH]";
 
+#define DEFAULT_COALESCE_INTERVAL_MS 50
+
+// Reconnect backoff bounds for a lost or unreachable PipeWire daemon
+#define RECONNECT_INITIAL_DELAY_MS 1000
+#define RECONNECT_MAX_DELAY_MS 30000
+
 static struct argp_option options[] = {
     {"show-device-name", 'd', 0, 0, "Show the audio device name in the OSD", 0},
     {"device-map", 'm', "FILE", 0, "File containing device name mappings", 0},
+    {"interval", 'i', "MS", 0, "Coalesce volume events, dispatching at most once per MS milliseconds (default 50, 0 disables)", 0},
+    {"volume-curve", 'c', "CURVE", 0, "Raw volume to percent mapping: cubic (default), linear, or a custom exponent like 0.5", 0},
+    {"soak", 0x100, "N", OPTION_HIDDEN, "Run N synthetic volume updates through the dispatch path and exit (leak soak mode)", 0},
+    {"bench", 0x105, "N", 0, "Benchmark: replay N synthetic volume events through the dispatch path against a stub and report throughput and latency (combine with --direct to exercise the pipe delivery path)", 0},
+    {"record", 0x106, "FILE", 0, "Append every incoming mixer/default-node event to a binary trace FILE", 0},
+    {"replay", 0x107, "FILE", 0, "Feed a recorded trace back through the event path without PipeWire and report throughput and latency", 0},
+    {"replay-speed", 0x108, "FACTOR", 0, "Replay speed multiplier (default 1.0 = original timing, 0 = as fast as possible)", 0},
+    {"log-ring", 0x101, "FILE", 0, "Write all log messages to a binary ring FILE (decode with logdump)", 0},
+    {"direct", 0x102, 0, 0, "Write the server protocol directly to its pipe instead of spawning the client", 0},
+    {"monitor-source", 's', 0, 0, "Also monitor the default Audio/Source (microphone) in the same process", 0},
+    {"watch-leds", 0x103, "DEVICE", 0, "Watch keyboard lock LEDs on the given evdev DEVICE (e.g. /dev/input/event0)", 0},
+    {"watch-backlight", 0x104, "DIR", 0, "Watch the sysfs backlight at DIR (e.g. /sys/class/backlight/intel_backlight)", 0},
+    {"state-file", 0x109, "FILE", 0, "Persist the default node and last volume to FILE for warm restarts (default $XDG_RUNTIME_DIR/wayland-osd-monitor.state, \"none\" disables)", 0},
+    {"seat", 0x10a, "SOCKET", 0, "Attach to the PipeWire instance named SOCKET (remote.name); repeat for multi-seat hosts, omit for the default socket", 0},
     {0, 0, 0, 0, 0, 0}
 };
 
-typedef struct {
-    char *pattern;
-    char *display_name;
-} DeviceMapping;
+typedef struct Context Context;
 
+// Parsed per-node mixer state, cached so the dispatch path and
+// default-device switches read a struct instead of re-querying the
+// mixer API per event. muted is gboolean because g_variant_lookup "b"
+// writes a full gboolean.
 typedef struct {
-    DeviceMapping *mappings;
-    size_t count;
-} DeviceMappings;
-
+  double volume;
+  double step;
+  gboolean muted;
+} NodeVolumeState;
+
+// Per-endpoint-class monitoring state. Sink and source each track their
+// own default node, dedupe cache and coalescing stage, but share one
+// PipeWire connection, object manager and device-map table.
 typedef struct {
+  Context *context;
+  const char *media_class;   // e.g. "Audio/Sink"
+  const char *message_type;  // server protocol "type" field
+  bool enabled;
+  u_int32_t node_id;
+  gchar *default_node_name;
+  bool has_last_state;
+  int last_volume;
+  bool last_muted;
+  guint dispatch_timer_id;
+  bool pending_dispatch;
+  int pending_volume;
+  bool pending_muted;
+  uint64_t pending_event_ns; // signal-receipt timestamp of the pending event
+} Endpoint;
+
+enum { ENDPOINT_SINK, ENDPOINT_SOURCE, ENDPOINT_COUNT };
+
+// Startup timeline checkpoints, in the order the async init chain
+// reaches them. Each is stamped once, on the first connection attempt
+// that gets there; time-to-first-OSD attribution comes from the deltas.
+enum {
+  STARTUP_MAIN,       // process entry
+  STARTUP_CONNECTED,  // wp_core_connect() returned
+  STARTUP_COMPONENTS, // both API components loaded
+  STARTUP_PLUGINS,    // all plugins activated
+  STARTUP_READY,      // object manager installed, signals wired
+  STARTUP_STAGE_COUNT
+};
+
+// The four argument shapes of the one-shot client invocation
+// (mute/device combinations), prebuilt once so a fallback spawn only
+// overwrites the volume string and device pointer.
+enum {
+  SPAWN_PLAIN,
+  SPAWN_MUTE,
+  SPAWN_DEVICE,
+  SPAWN_MUTE_DEVICE,
+  SPAWN_SHAPE_COUNT
+};
+
+struct Context {
   WpCore *core;
   WpObjectManager *om;
   GPtrArray *apis;
   WpPlugin *mixer_api;
   WpPlugin *def_nodes_api;
   u_int32_t pending_plugins;
-  gchar *default_node_name;
-  u_int32_t node_id;
+  u_int32_t pending_components;
+  Endpoint endpoints[ENDPOINT_COUNT];
+  GHashTable *node_names;  // node id -> "node.name" string in node_arena
+  GHashTable *node_states; // node id -> NodeVolumeState in node_arena
+  ScratchArena node_arena; // backs both caches; reset on reconnect
   const char *client_path;
+  pid_t client_pid;
+  int client_stdin_fd;
+  pid_t oneshot_pid;
+  bool direct;
+  int server_fd;
   bool show_device_name;
-  DeviceMappings device_mappings;
-} Context;
-
-struct arguments {
-    char *client_path;
-    bool show_device_name;
-    char *device_map_file;
+  guint coalesce_interval_ms;
+  const char *seat_name;            // PipeWire remote.name, NULL = default
+  DeviceMappings *device_mappings;  // shared across seats, owned by main()
+  const char *device_map_file;
+  GFileMonitor *device_map_monitor;
+  int led_fd;
+  int backlight_inotify_fd;
+  int backlight_max;
+  gchar *backlight_brightness_path;
+  guint reconnect_timer_id;
+  guint reconnect_delay_ms;
+  Stats stats;
+  uint64_t event_start_ns; // timestamp of the mixer signal being handled
+  TraceWriter trace;
+  bool tracing;
+  char *spawn_argv[SPAWN_SHAPE_COUNT][7]; // see init_spawn_argv
+  char spawn_volume_str[16];
+  VolumeCurve volume_curve;
+  WarmState warm_state;
+  bool warm_state_ok;
+  uint64_t startup_stage_ns[STARTUP_STAGE_COUNT];
+  bool startup_reported;
 };
 
-static void free_device_mappings(DeviceMappings *mappings) {
-    if (mappings->mappings) {
-        for (size_t i = 0; i < mappings->count; i++) {
-            free(mappings->mappings[i].pattern);
-            free(mappings->mappings[i].display_name);
-        }
-        free(mappings->mappings);
-    }
-    mappings->mappings = NULL;
-    mappings->count = 0;
-}
-
-static bool load_device_mappings(const char *filename, DeviceMappings *mappings) {
-    if (!filename) {
-        mappings->mappings = NULL;
-        mappings->count = 0;
-        return true;
-    }
+// Defined with the rest of the connection lifecycle below; error paths in
+// the async setup chain need it early.
+static void schedule_reconnect(Context *context);
 
-    FILE *file = fopen(filename, "r");
-    if (!file) {
-        log_error("Failed to open device mapping file: %s", filename);
-        return false;
-    }
-
-    char *line = NULL;
-    size_t len = 0;
-    ssize_t read;
-    size_t capacity = 10;
-    size_t count = 0;
-
-    mappings->mappings = malloc(capacity * sizeof(DeviceMapping));
-    if (!mappings->mappings) {
-        fclose(file);
-        return false;
-    }
-
-    while ((read = getline(&line, &len, file)) != -1) {
-        if (read > 0 && line[read-1] == '\n') {
-            line[read-1] = '\0';
-        }
-
-        // Skip empty lines and comments
-        if (read <= 1 || line[0] == '#') {
-            continue;
-        }
-
-        char *separator = strchr(line, '=');
-        if (!separator) {
-            continue;
-        }
-
-        *separator = '\0';
-        char *pattern = g_strdup(line);
-        char *display_name = g_strdup(separator + 1);
-
-        if (!pattern || !display_name) {
-            g_free(pattern);
-            g_free(display_name);
-            continue;
-        }
-
-        if (count >= capacity) {
-            capacity *= 2;
-            DeviceMapping *new_mappings = realloc(mappings->mappings, capacity * sizeof(DeviceMapping));
-            if (!new_mappings) {
-                free(pattern);
-                free(display_name);
-                break;
-            }
-            mappings->mappings = new_mappings;
-        }
+static const char *seat_label(const Context *context) {
+  return context->seat_name != NULL ? context->seat_name : "default";
+}
 
-        mappings->mappings[count].pattern = pattern;
-        mappings->mappings[count].display_name = display_name;
-        count++;
-    }
+static void startup_mark(Context *context, int stage) {
+  if (context->startup_stage_ns[stage] == 0)
+    context->startup_stage_ns[stage] = monotonic_ns();
+}
 
-    free(line);
-    fclose(file);
-    mappings->count = count;
-    return true;
+// One-line cold-start attribution across the async init chain, emitted
+// once when the first connection is fully wired. Retries and backoff
+// waits are charged to the stage they delayed, so the total is honest
+// wall time from process entry to ready.
+static void startup_report(Context *context) {
+  const uint64_t *ns = context->startup_stage_ns;
+  if (context->startup_reported || ns[STARTUP_MAIN] == 0)
+    return;
+  context->startup_reported = true;
+
+  char connect[16], components[16], plugins[16], install[16], total[16];
+  stats_format_ns(ns[STARTUP_CONNECTED] - ns[STARTUP_MAIN], connect,
+                  sizeof(connect));
+  stats_format_ns(ns[STARTUP_COMPONENTS] - ns[STARTUP_CONNECTED], components,
+                  sizeof(components));
+  stats_format_ns(ns[STARTUP_PLUGINS] - ns[STARTUP_COMPONENTS], plugins,
+                  sizeof(plugins));
+  stats_format_ns(ns[STARTUP_READY] - ns[STARTUP_PLUGINS], install,
+                  sizeof(install));
+  stats_format_ns(ns[STARTUP_READY] - ns[STARTUP_MAIN], total, sizeof(total));
+  log_info("startup: seat=%s connect=%s components=%s plugins=%s install=%s "
+           "total=%s",
+           seat_label(context), connect, components, plugins, install, total);
+
+  // Raw nanoseconds on stdout for the hardware-matrix harness
+  if (g_getenv("WAYLAND_OSD_STARTUP_TIMINGS") != NULL) {
+    printf("startup_ns seat=%s connect=%lu components=%lu plugins=%lu "
+           "install=%lu total=%lu\n",
+           seat_label(context),
+           (unsigned long)(ns[STARTUP_CONNECTED] - ns[STARTUP_MAIN]),
+           (unsigned long)(ns[STARTUP_COMPONENTS] - ns[STARTUP_CONNECTED]),
+           (unsigned long)(ns[STARTUP_PLUGINS] - ns[STARTUP_COMPONENTS]),
+           (unsigned long)(ns[STARTUP_READY] - ns[STARTUP_PLUGINS]),
+           (unsigned long)(ns[STARTUP_READY] - ns[STARTUP_MAIN]));
+    fflush(stdout);
+  }
 }
 
-static const char* get_mapped_device_name(const DeviceMappings *mappings, const char *device_name) {
-    if (!mappings || !mappings->mappings || !device_name) {
-        return device_name;
-    }
+struct arguments {
+    char *client_path;
+    bool show_device_name;
+    char *device_map_file;
+    guint coalesce_interval_ms;
+    unsigned long soak_iterations;
+    char *log_ring_file;
+    bool direct;
+    bool monitor_source;
+    char *led_device;
+    char *backlight_dir;
+    unsigned long bench_iterations;
+    char *record_file;
+    char *replay_file;
+    double replay_speed;
+    double curve_exponent;
+    char *state_file;
+    GPtrArray *seats; // remote.name strings; NULL means one default seat
+};
 
-    for (size_t i = 0; i < mappings->count; i++) {
-        if (strstr(device_name, mappings->mappings[i].pattern) != NULL) {
-            return mappings->mappings[i].display_name;
-        }
-    }
+// Bounded flight-recorder trace, cheap enough to leave on at TRACE level
+#define LOG_RING_DEFAULT_SIZE (1024 * 1024)
 
-    return device_name;
-}
+// Must match PIPE_PATH in wayland-osd-client and wayland-osd-server
+#define OSD_PIPE_PATH "/tmp/wayland-osd.pipe"
 
 static error_t parse_opt(int key, char *arg, struct argp_state *state) {
     struct arguments *arguments = state->input;
@@ -159,6 +246,71 @@ static error_t parse_opt(int key, char *arg, struct argp_state *state) {
         case 'm':
             arguments->device_map_file = arg;
             break;
+        case 'c':
+            if (!volume_curve_parse(arg, &arguments->curve_exponent))
+                argp_error(state, "Invalid volume curve: %s", arg);
+            break;
+        case 'i': {
+            char *end = NULL;
+            unsigned long interval = strtoul(arg, &end, 10);
+            if (end == arg || *end != '\0' || interval > G_MAXUINT)
+                argp_error(state, "Invalid interval: %s", arg);
+            arguments->coalesce_interval_ms = (guint)interval;
+            break;
+        }
+        case 0x100: {
+            char *end = NULL;
+            unsigned long iterations = strtoul(arg, &end, 10);
+            if (end == arg || *end != '\0' || iterations == 0)
+                argp_error(state, "Invalid soak iteration count: %s", arg);
+            arguments->soak_iterations = iterations;
+            break;
+        }
+        case 0x101:
+            arguments->log_ring_file = arg;
+            break;
+        case 0x102:
+            arguments->direct = true;
+            break;
+        case 's':
+            arguments->monitor_source = true;
+            break;
+        case 0x103:
+            arguments->led_device = arg;
+            break;
+        case 0x104:
+            arguments->backlight_dir = arg;
+            break;
+        case 0x105: {
+            char *end = NULL;
+            unsigned long iterations = strtoul(arg, &end, 10);
+            if (end == arg || *end != '\0' || iterations == 0)
+                argp_error(state, "Invalid bench iteration count: %s", arg);
+            arguments->bench_iterations = iterations;
+            break;
+        }
+        case 0x106:
+            arguments->record_file = arg;
+            break;
+        case 0x107:
+            arguments->replay_file = arg;
+            break;
+        case 0x108: {
+            char *end = NULL;
+            double speed = strtod(arg, &end);
+            if (end == arg || *end != '\0' || speed < 0.0)
+                argp_error(state, "Invalid replay speed: %s", arg);
+            arguments->replay_speed = speed;
+            break;
+        }
+        case 0x109:
+            arguments->state_file = arg;
+            break;
+        case 0x10a:
+            if (arguments->seats == NULL)
+                arguments->seats = g_ptr_array_new();
+            g_ptr_array_add(arguments->seats, arg);
+            break;
         case ARGP_KEY_ARG:
             if (state->arg_num >= 1)
                 argp_usage(state);
@@ -178,91 +330,985 @@ static struct argp argp = {options, parse_opt, args_doc, doc, 0, 0, 0};
 
 bool is_valid_node_id(u_int32_t id) { return id > 0 && id < G_MAXUINT32; }
 
+static void init_endpoints(Context *context, bool monitor_source) {
+  context->endpoints[ENDPOINT_SINK] = (Endpoint){
+      .context = context,
+      .media_class = "Audio/Sink",
+      .message_type = "volume",
+      .enabled = true,
+  };
+  context->endpoints[ENDPOINT_SOURCE] = (Endpoint){
+      .context = context,
+      .media_class = "Audio/Source",
+      .message_type = "source-volume",
+      .enabled = monitor_source,
+  };
+}
+
+// Drop our end of the persistent client; the child watch added at spawn
+// time takes care of reaping once the process exits.
+static void close_persistent_client(Context *context) {
+  if (context->client_stdin_fd >= 0) {
+    close(context->client_stdin_fd);
+    context->client_stdin_fd = -1;
+  }
+  context->client_pid = 0;
+}
+
+static void on_persistent_client_exited(GPid pid, gint status, gpointer user_data) {
+  Context *context = user_data;
+
+  log_warn("Persistent client (pid %d) exited with status %d", pid, status);
+  g_spawn_close_pid(pid);
+
+  if (context->client_pid == pid) {
+    // Exit we didn't already notice via EPIPE; drop the stale pipe so the
+    // next event respawns the client
+    close_persistent_client(context);
+  }
+}
+
+static void on_oneshot_client_exited(GPid pid, __attribute__((unused)) gint status,
+                                     gpointer user_data) {
+  Context *context = user_data;
+
+  g_spawn_close_pid(pid);
+  if (context->oneshot_pid == pid) {
+    context->oneshot_pid = 0;
+  }
+}
+
+// Drop every object tied to the current PipeWire connection while keeping
+// the parsed configuration (device mappings, endpoints, watchers) intact,
+// so a reconnect only re-pays the connection wiring.
+static void teardown_connection(Context *context) {
+  for (int i = 0; i < ENDPOINT_COUNT; i++) {
+    Endpoint *endpoint = &context->endpoints[i];
+    if (endpoint->dispatch_timer_id != 0) {
+      g_source_remove(endpoint->dispatch_timer_id);
+      endpoint->dispatch_timer_id = 0;
+    }
+    endpoint->pending_dispatch = false;
+    endpoint->has_last_state = false;
+    endpoint->node_id = 0;
+    g_free(endpoint->default_node_name);
+    endpoint->default_node_name = NULL;
+  }
+  if (context->node_names)
+    g_hash_table_remove_all(context->node_names);
+  if (context->node_states)
+    g_hash_table_remove_all(context->node_states);
+  scratch_arena_reset(&context->node_arena);
+  if (context->def_nodes_api) {
+    g_signal_handlers_disconnect_by_data(context->def_nodes_api, context);
+    g_object_unref(context->def_nodes_api);
+    context->def_nodes_api = NULL;
+  }
+  if (context->mixer_api) {
+    g_signal_handlers_disconnect_by_data(context->mixer_api, context);
+    g_object_unref(context->mixer_api);
+    context->mixer_api = NULL;
+  }
+  if (context->apis) {
+    g_ptr_array_unref(context->apis);
+    context->apis = NULL;
+  }
+  if (context->om) {
+    g_signal_handlers_disconnect_by_data(context->om, context);
+    g_object_unref(context->om);
+    context->om = NULL;
+  }
+  if (context->core) {
+    // An explicit disconnect also emits "disconnected"; drop our handler
+    // first or tearing down a healthy connection would schedule a
+    // reconnect and cycle the connection forever
+    g_signal_handlers_disconnect_by_data(context->core, context);
+    wp_core_disconnect(context->core);
+    g_object_unref(context->core);
+    context->core = NULL;
+  }
+  context->pending_plugins = 0;
+  context->pending_components = 0;
+}
+
 static void cleanup_context(Context *context) {
   if (context) {
-    if (context->apis)
-      g_ptr_array_unref(context->apis);
-    if (context->om)
-      g_object_unref(context->om);
-    if (context->core) {
-      wp_core_disconnect(context->core);
-      g_object_unref(context->core);
-    }
-    free_device_mappings(&context->device_mappings);
+    teardown_connection(context);
+    if (context->reconnect_timer_id != 0)
+      g_source_remove(context->reconnect_timer_id);
+    if (context->node_names)
+      g_hash_table_destroy(context->node_names);
+    if (context->node_states)
+      g_hash_table_destroy(context->node_states);
+    close_persistent_client(context);
+    if (context->server_fd >= 0)
+      close(context->server_fd);
+    if (context->led_fd >= 0)
+      close(context->led_fd);
+    if (context->backlight_inotify_fd >= 0)
+      close(context->backlight_inotify_fd);
+    trace_writer_close(&context->trace);
+    warm_state_close(&context->warm_state);
+    if (context->device_map_monitor)
+      g_object_unref(context->device_map_monitor);
+    g_free(context->backlight_brightness_path);
     g_free(context);
   }
 }
 
-void run_client(const char *client_path, int volume_percent, bool is_muted, const char *device_name) {
-  log_debug("Running client with volume: %d%%, muted: %s", volume_percent, is_muted ? "true" : "false");
+// Escape a string for embedding in a JSON string literal. Returns false if
+// the escaped result did not fit in dst.
+static bool json_escape(const char *src, char *dst, size_t dst_size) {
+  size_t out = 0;
+  for (const char *p = src; *p != '\0'; p++) {
+    unsigned char c = (unsigned char)*p;
+    if (c == '"' || c == '\\') {
+      if (out + 2 >= dst_size)
+        return false;
+      dst[out++] = '\\';
+      dst[out++] = (char)c;
+    } else if (c < 0x20) {
+      if (out + 6 >= dst_size)
+        return false;
+      out += (size_t)snprintf(dst + out, dst_size - out, "\\u%04x", c);
+    } else {
+      if (out + 1 >= dst_size)
+        return false;
+      dst[out++] = (char)c;
+    }
+  }
+  dst[out] = '\0';
+  return true;
+}
+
+// Build the server protocol message the client forwards verbatim.
+// Returns the message length, or -1 if it did not fit.
+static int format_volume_message(char *buf, size_t buf_size, const char *type,
+                                 int volume_percent, bool is_muted,
+                                 const char *device_name) {
+  int len;
+  if (device_name != NULL) {
+    char escaped[512];
+    if (!json_escape(device_name, escaped, sizeof(escaped)))
+      return -1;
+    len = snprintf(buf, buf_size,
+                   "{\"type\":\"%s\",\"value\":%d,\"max_value\":100,"
+                   "\"muted\":%s,\"device_name\":\"%s\"}",
+                   type, volume_percent, is_muted ? "true" : "false", escaped);
+  } else {
+    len = snprintf(buf, buf_size,
+                   "{\"type\":\"%s\",\"value\":%d,\"max_value\":100,"
+                   "\"muted\":%s,\"device_name\":null}",
+                   type, volume_percent, is_muted ? "true" : "false");
+  }
+  if (len < 0 || (size_t)len >= buf_size)
+    return -1;
+  return len;
+}
+
+// Prebuild the argv vectors for every one-shot invocation shape. The
+// volume entries all alias spawn_volume_str, so a spawn only has to
+// snprintf the number into that one buffer; the device entries are
+// pointer slots filled in per event.
+static void init_spawn_argv(Context *context) {
+  char *path = (char *)context->client_path;
+  char *volume = context->spawn_volume_str;
+
+  char **argv = context->spawn_argv[SPAWN_PLAIN];
+  argv[0] = path; argv[1] = "audio"; argv[2] = volume; argv[3] = NULL;
+
+  argv = context->spawn_argv[SPAWN_MUTE];
+  argv[0] = path; argv[1] = "audio"; argv[2] = volume; argv[3] = "--mute";
+  argv[4] = NULL;
+
+  argv = context->spawn_argv[SPAWN_DEVICE];
+  argv[0] = path; argv[1] = "audio"; argv[2] = volume; argv[3] = "--device";
+  argv[5] = NULL;
+
+  argv = context->spawn_argv[SPAWN_MUTE_DEVICE];
+  argv[0] = path; argv[1] = "audio"; argv[2] = volume; argv[3] = "--mute";
+  argv[4] = "--device"; argv[6] = NULL;
+}
 
-  pid_t pid = fork();
-  if (pid == -1) {
-    log_error("Failed to fork process");
+static bool spawn_persistent_client(Context *context) {
+  // O_CLOEXEC so later spawns (other seats' clients, one-shot fallbacks)
+  // don't inherit this write end and keep the listener alive past us; the
+  // adddup2 below clears the flag on the child's own stdin
+  int fds[2];
+  if (pipe2(fds, O_CLOEXEC) == -1) {
+    log_error("Failed to create client pipe: %s", strerror(errno));
+    return false;
+  }
+
+  // posix_spawn over fork: no page-table copy of a parent carrying the
+  // device-map arena and caches
+  posix_spawn_file_actions_t actions;
+  posix_spawn_file_actions_init(&actions);
+  posix_spawn_file_actions_adddup2(&actions, fds[0], STDIN_FILENO);
+  posix_spawn_file_actions_addclose(&actions, fds[0]);
+  posix_spawn_file_actions_addclose(&actions, fds[1]);
+
+  char *argv[] = {(char *)context->client_path, "listen", NULL};
+  pid_t pid;
+  int err = posix_spawn(&pid, context->client_path, &actions, NULL, argv,
+                        environ);
+  posix_spawn_file_actions_destroy(&actions);
+  close(fds[0]);
+
+  if (err != 0) {
+    log_error("Failed to spawn client at '%s': %s", context->client_path,
+              strerror(err));
+    close(fds[1]);
+    return false;
+  }
+
+  context->client_pid = pid;
+  context->client_stdin_fd = fds[1];
+  context->stats.clients_spawned++;
+  g_child_watch_add(pid, on_persistent_client_exited, context);
+  log_info("Started persistent client (pid %d)", pid);
+  return true;
+}
+
+// Write one NUL-terminated message to the persistent client, the same
+// framing the server expects on its pipe.
+static bool client_stream_send(Context *context, const char *message, size_t len) {
+  if (context->client_stdin_fd < 0)
+    return false;
+
+  size_t total = len + 1; // include the NUL terminator
+  size_t written = 0;
+  while (written < total) {
+    ssize_t n = write(context->client_stdin_fd, message + written, total - written);
+    if (n == -1) {
+      if (errno == EINTR)
+        continue;
+      log_warn("Failed to write to persistent client: %s", strerror(errno));
+      close_persistent_client(context);
+      return false;
+    }
+    written += (size_t)n;
+  }
+  return true;
+}
+
+// One-shot fallback used when the persistent client cannot be started.
+// At most one fallback client runs at a time: stacking them would leak
+// processes during bursts and make the OSD windows race each other.
+static void run_client_oneshot(Endpoint *endpoint, int volume_percent,
+                               bool is_muted, const char *device_name) {
+  Context *context = endpoint->context;
+  const char *client_path = context->client_path;
+
+  // The client CLI only has an "audio" (sink) subcommand; source updates
+  // have no one-shot equivalent
+  if (endpoint != &context->endpoints[ENDPOINT_SINK]) {
+    log_debug("No one-shot fallback for %s updates, dropping",
+              endpoint->media_class);
     return;
   }
 
-  if (pid == 0) { // Child process
-    char volume_str[16];
-    snprintf(volume_str, sizeof(volume_str), "%d", volume_percent);
+  if (context->oneshot_pid > 0) {
+    log_debug("Previous client (pid %d) still running, skipping spawn",
+              context->oneshot_pid);
+    return;
+  }
 
-    if (is_muted && device_name != NULL) {
-      execl(client_path, client_path, "audio", volume_str, "--mute", "--device", device_name, NULL);
-    } else if (is_muted && device_name == NULL) {
-      execl(client_path, client_path, "audio", volume_str, "--mute", NULL);
-    }  else if (device_name != NULL) {
-      execl(client_path, client_path, "audio", volume_str, "--device", device_name, NULL);
-    } else {
-      execl(client_path, client_path, "audio", volume_str, NULL);
+  // Pick the prebuilt argv shape and fill in the two mutable slots
+  int shape = is_muted ? (device_name != NULL ? SPAWN_MUTE_DEVICE : SPAWN_MUTE)
+                       : (device_name != NULL ? SPAWN_DEVICE : SPAWN_PLAIN);
+  snprintf(context->spawn_volume_str, sizeof(context->spawn_volume_str), "%d",
+           volume_percent);
+  if (shape == SPAWN_DEVICE)
+    context->spawn_argv[SPAWN_DEVICE][4] = (char *)device_name;
+  else if (shape == SPAWN_MUTE_DEVICE)
+    context->spawn_argv[SPAWN_MUTE_DEVICE][5] = (char *)device_name;
+
+  pid_t pid;
+  int err = posix_spawn(&pid, client_path, NULL, NULL,
+                        context->spawn_argv[shape], environ);
+  if (err != 0) {
+    log_error("Failed to spawn client at '%s': %s", client_path,
+              strerror(err));
+    return;
+  }
+
+  context->oneshot_pid = pid;
+  context->stats.clients_spawned++;
+  g_child_watch_add(pid, on_oneshot_client_exited, context);
+}
+
+// Direct mode: one non-blocking write of the server protocol message to
+// the server's pipe, no client process involved at all. Messages are
+// dropped rather than ever blocking the event loop.
+static bool direct_send(Context *context, const char *message, size_t len) {
+  for (int attempt = 0; attempt < 2; attempt++) {
+    if (context->server_fd < 0) {
+      context->server_fd =
+          open(OSD_PIPE_PATH, O_WRONLY | O_NONBLOCK | O_CLOEXEC);
+      if (context->server_fd < 0) {
+        // ENXIO: no server reading the pipe right now
+        log_debug("Failed to open server pipe %s: %s", OSD_PIPE_PATH,
+                  strerror(errno));
+        return false;
+      }
+    }
+
+    // Message plus NUL terminator, the server's record separator. PIPE_BUF
+    // guarantees the write is atomic at our message sizes.
+    ssize_t n = write(context->server_fd, message, len + 1);
+    if (n == (ssize_t)(len + 1)) {
+      return true;
+    }
+
+    if (n == -1 && errno == EAGAIN) {
+      log_warn("Server pipe full, dropping update");
+      return false;
     }
-    
-    // If execl returns, there was an error
-    log_error("Failed to execute client at '%s'", client_path);
-    exit(1);
+
+    // Server went away (EPIPE) or a short/failed write; reopen and retry
+    log_debug("Server pipe write failed: %s", n == -1 ? strerror(errno) : "short write");
+    close(context->server_fd);
+    context->server_fd = -1;
   }
+  return false;
 }
 
-void on_update_volume(Context *context, u_int32_t id) {
-  log_debug("updating volume", id);
-  GVariant *variant = NULL;
+// Deliver one already-formatted server protocol message over whichever
+// channel is configured: the server pipe in direct mode, the persistent
+// client otherwise (restarting it once if it died since the last event).
+static bool send_server_message(Context *context, const char *message, size_t len) {
+  bool sent;
+  if (context->direct) {
+    sent = direct_send(context, message, len);
+  } else if (context->client_stdin_fd < 0 && !spawn_persistent_client(context)) {
+    sent = false;
+  } else {
+    // Restart the client once if it died since the last event
+    sent = client_stream_send(context, message, len) ||
+           (spawn_persistent_client(context) &&
+            client_stream_send(context, message, len));
+  }
+
+  if (sent)
+    context->stats.messages_sent++;
+  return sent;
+}
+
+void run_client(Endpoint *endpoint, int volume_percent, bool is_muted, const char *device_name) {
+  Context *context = endpoint->context;
+  log_debug("Running client with volume: %d%%, muted: %s", volume_percent, is_muted ? "true" : "false");
+
+  char message[1024];
+  int len = format_volume_message(message, sizeof(message),
+                                  endpoint->message_type, volume_percent,
+                                  is_muted, device_name);
+  if (len < 0) {
+    log_error("Volume message too large, dropping update");
+    return;
+  }
+
+  if (send_server_message(context, message, (size_t)len))
+    return;
+
+  // Direct mode never falls back to processes; the drop was already logged
+  if (context->direct)
+    return;
+
+  log_warn("Persistent client unavailable, falling back to one-shot spawn");
+  run_client_oneshot(endpoint, volume_percent, is_muted, device_name);
+}
+
+static void dispatch_volume(Endpoint *endpoint, int volume, bool muted) {
+  Context *context = endpoint->context;
+  if (context->show_device_name) {
+    const char *display_name = get_mapped_device_name(context->device_mappings, endpoint->default_node_name);
+    log_info("Running client with volume: %d%%, muted: %s, device: %s", volume, muted ? "true" : "false", display_name);
+    run_client(endpoint, volume, muted, display_name);
+  } else {
+    log_info("Running client with volume: %d%%, muted: %s", volume, muted ? "true" : "false");
+    run_client(endpoint, volume, muted, NULL);
+  }
+
+  if (endpoint->pending_event_ns != 0) {
+    histogram_record(&context->stats.signal_to_dispatch,
+                     monotonic_ns() - endpoint->pending_event_ns);
+    endpoint->pending_event_ns = 0;
+  }
+
+  // Persisting is plain stores into the mapped state file; the next run
+  // restores this before its WirePlumber handshake completes
+  if (context->warm_state_ok) {
+    WarmStateSlot *slot = warm_state_slot(
+        &context->warm_state, (uint32_t)(endpoint - context->endpoints));
+    slot->node_id = endpoint->node_id;
+    slot->volume = volume;
+    slot->muted = muted ? 1 : 0;
+    // Restore skips unnamed slots, and update_default_node only writes the
+    // name when the default device changes — keep it current here too so a
+    // session that never switches devices still persists a usable slot
+    if (endpoint->default_node_name != NULL)
+      g_strlcpy(slot->node_name, endpoint->default_node_name,
+                sizeof(slot->node_name));
+    slot->has_state = 1;
+  }
+}
+
+static gboolean on_dispatch_timeout(gpointer user_data) {
+  Endpoint *endpoint = user_data;
+
+  if (!endpoint->pending_dispatch) {
+    // The burst is over, stop ticking until the next event arms us again
+    endpoint->dispatch_timer_id = 0;
+    return G_SOURCE_REMOVE;
+  }
 
-  if (!is_valid_node_id(id)) {
-    log_error("Invalid node id: %d", id);
+  endpoint->pending_dispatch = false;
+  dispatch_volume(endpoint, endpoint->pending_volume, endpoint->pending_muted);
+  return G_SOURCE_CONTINUE;
+}
+
+// Leading-edge coalescing: the first event of a burst is dispatched
+// immediately, then at most one dispatch per interval carries the latest
+// state, so the OSD never lags more than one interval behind the mixer.
+static void queue_volume_dispatch(Endpoint *endpoint, int volume, bool muted) {
+  endpoint->pending_event_ns = endpoint->context->event_start_ns;
+
+  if (endpoint->context->coalesce_interval_ms == 0) {
+    dispatch_volume(endpoint, volume, muted);
+    return;
+  }
+
+  endpoint->pending_volume = volume;
+  endpoint->pending_muted = muted;
+
+  if (endpoint->dispatch_timer_id != 0) {
+    endpoint->pending_dispatch = true;
+    endpoint->context->stats.events_coalesced++;
     return;
   }
 
+  endpoint->pending_dispatch = false;
+  dispatch_volume(endpoint, volume, muted);
+  // High priority so the trailing-edge dispatch outranks housekeeping
+  // sources (notably the deferred log pump) when the loop is saturated
+  endpoint->dispatch_timer_id = g_timeout_add_full(
+      G_PRIORITY_HIGH, endpoint->context->coalesce_interval_ms,
+      on_dispatch_timeout, endpoint, NULL);
+}
+
+static void parse_volume_variant(GVariant *variant, NodeVolumeState *state) {
+  // The mixer-api signal may hand us a floating variant; taking a real
+  // reference first makes the unref below balanced either way. Unreffing
+  // the floating reference directly is what used to segfault here.
+  variant = g_variant_take_ref(variant);
+
+  g_variant_lookup(variant, "volume", "d", &state->volume);
+  g_variant_lookup(variant, "step", "d", &state->step);
+  g_variant_lookup(variant, "mute", "b", &state->muted);
+
+  g_variant_unref(variant);
+}
+
+static void handle_volume_state(Endpoint *endpoint, const NodeVolumeState *state) {
+  Context *context = endpoint->context;
+  bool muted = state->muted != FALSE;
+
+  if (context->tracing) {
+    TraceRecord record = {
+        .mono_ns = monotonic_ns(),
+        .type = TRACE_EVENT_VOLUME,
+        .endpoint = (uint8_t)(endpoint - context->endpoints),
+        .muted = muted,
+        .node_id = endpoint->node_id,
+        .volume = state->volume,
+        .step = state->step,
+    };
+    trace_writer_record(&context->trace, &record, NULL);
+  }
+
+  int volume = volume_curve_percent(&context->volume_curve, state->volume);
+
+  // WirePlumber also fires "changed" for channel-map and other non-volume
+  // updates, so skip the dispatch when nothing the OSD shows has changed
+  if (endpoint->has_last_state && volume == endpoint->last_volume &&
+      muted == endpoint->last_muted) {
+    log_debug("Volume unchanged (%d%%, muted: %s), skipping dispatch", volume,
+              muted ? "true" : "false");
+    context->stats.events_deduped++;
+    return;
+  }
+  endpoint->has_last_state = true;
+  endpoint->last_volume = volume;
+  endpoint->last_muted = muted;
+
+  log_info("Volume: %d, min_step: %f, muted: %s", volume, state->step, muted ? "true" : "false");
+
+  // Hand off to the coalescing stage instead of calling the client directly
+  queue_volume_dispatch(endpoint, volume, muted);
+}
+
+// Synthetic paths (soak, bench, replay) enter here with a built variant
+static void handle_volume_variant(Endpoint *endpoint, GVariant *variant) {
+  NodeVolumeState state = {0};
+  parse_volume_variant(variant, &state);
+  handle_volume_state(endpoint, &state);
+}
+
+// Re-query the mixer for one node and update its cache entry. This is the
+// only place the synchronous get-volume query remains; everything
+// downstream reads the cached struct.
+static NodeVolumeState *refresh_node_state(Context *context, u_int32_t id) {
+  GVariant *variant = NULL;
   g_signal_emit_by_name(context->mixer_api, "get-volume", id, &variant);
+  if (variant == NULL)
+    return NULL;
+
+  NodeVolumeState *state =
+      g_hash_table_lookup(context->node_states, GUINT_TO_POINTER(id));
+  if (state == NULL) {
+    state = scratch_arena_alloc(&context->node_arena, sizeof(*state));
+    if (state == NULL) {
+      g_variant_unref(g_variant_take_ref(variant));
+      return NULL;
+    }
+    *state = (NodeVolumeState){0};
+    g_hash_table_insert(context->node_states, GUINT_TO_POINTER(id), state);
+  }
+  parse_volume_variant(variant, state);
+  return state;
+}
+
+// One synthetic mixer event through the full variant-handling and
+// dispatch path. Successive events differ so dedupe does not absorb them.
+static void synth_volume_event(Context *context, unsigned long i) {
+  context->event_start_ns = monotonic_ns();
+  context->stats.events_seen++;
+  GVariantBuilder builder;
+  g_variant_builder_init(&builder, G_VARIANT_TYPE_VARDICT);
+  g_variant_builder_add(&builder, "{sv}", "volume",
+                        g_variant_new_double((double)(i % 101) / 100.0));
+  g_variant_builder_add(&builder, "{sv}", "step", g_variant_new_double(0.01));
+  g_variant_builder_add(&builder, "{sv}", "mute",
+                        g_variant_new_boolean(i % 7 == 0));
+  handle_volume_variant(&context->endpoints[ENDPOINT_SINK],
+                        g_variant_builder_end(&builder));
+}
 
-  if (variant == NULL) {
-    log_fatal("Node %d doesn't support volume", id);
-    exit(1);
+// Hidden soak mode: drive the variant handling and dispatch path with
+// synthetic updates so leak-freedom over millions of events can be
+// demonstrated with valgrind/massif without a live PipeWire session.
+static int run_soak(Context *context, unsigned long iterations) {
+  int devnull = open("/dev/null", O_WRONLY);
+  if (devnull == -1) {
+    log_error("Failed to open /dev/null: %s", strerror(errno));
+    return 1;
   }
 
-  double raw_volume;
-  double raw_min_step;
-  bool raw_muted;
+  // Write dispatches into /dev/null and keep the path fully synchronous
+  context->client_stdin_fd = devnull;
+  context->coalesce_interval_ms = 0;
 
-  g_variant_lookup(variant, "volume", "d", &raw_volume);
-  g_variant_lookup(variant, "step", "d", &raw_min_step);
-  g_variant_lookup(variant, "mute", "b", &raw_muted);
+  log_info("Soak mode: %lu synthetic volume updates", iterations);
 
-  // FIXME: For some reason, trying to free the variant causes a segfault
-  // g_clear_pointer(&variant, g_variant_unref);
+  for (unsigned long i = 0; i < iterations; i++) {
+    synth_volume_event(context, i);
+  }
 
-  int volume = (int)lround(cbrt(raw_volume) * 100);
+  log_info("Soak complete");
+  stats_log(&context->stats);
+  close(devnull);
+  context->client_stdin_fd = -1;
+  return 0;
+}
 
-  log_info("Volume: %d, min_step: %f, muted: %s", volume, raw_min_step, raw_muted ? "true" : "false");
-  
-  // Call the wayland-osd-client
-  
-  if (context->show_device_name) {
-    const char *display_name = get_mapped_device_name(&context->device_mappings, context->default_node_name);
-    log_info("Running client with volume: %d%%, muted: %s, device: %s", volume, raw_muted ? "true" : "false", display_name);
-    run_client(context->client_path, volume, raw_muted, display_name);
+// Benchmark mode: the same synthetic replay as soak, but timed. Without
+// --direct, dispatches go through the persistent-client write path into
+// /dev/null; with --direct, a forked pipe-draining stub stands in for the
+// server so the full fifo delivery path is exercised. Reports events/sec,
+// the stats-layer latency histograms, and heap growth per event.
+static int run_bench(Context *context, unsigned long iterations) {
+  pid_t stub_pid = 0;
+  int devnull = -1;
+
+  if (context->direct) {
+    unlink(OSD_PIPE_PATH);
+    if (mkfifo(OSD_PIPE_PATH, 0600) == -1) {
+      log_error("Failed to create stub pipe %s: %s", OSD_PIPE_PATH,
+                strerror(errno));
+      return 1;
+    }
+    stub_pid = fork();
+    if (stub_pid == -1) {
+      log_error("Failed to fork stub server");
+      return 1;
+    }
+    if (stub_pid == 0) { // Stub server: drain the pipe until EOF
+      int fd = open(OSD_PIPE_PATH, O_RDONLY);
+      char buf[4096];
+      while (fd >= 0 && read(fd, buf, sizeof(buf)) > 0)
+        ;
+      _exit(0);
+    }
   } else {
-    log_info("Running client with volume: %d%%, muted: %s", volume, raw_muted ? "true" : "false");
-    run_client(context->client_path, volume, raw_muted, NULL);
+    devnull = open("/dev/null", O_WRONLY);
+    if (devnull == -1) {
+      log_error("Failed to open /dev/null: %s", strerror(errno));
+      return 1;
+    }
+    context->client_stdin_fd = devnull;
   }
+
+  // The coalescing timer needs a running main loop, which bench does not
+  // have; every event reaches dispatch
+  context->coalesce_interval_ms = 0;
+
+  // A fixed default-node name so -d/-m exercise the device-map lookup
+  context->endpoints[ENDPOINT_SINK].default_node_name =
+      g_strdup("bench.pattern-42.analog-stereo");
+
+  log_info("Bench mode: %lu synthetic volume events (%s delivery)",
+           iterations, context->direct ? "direct pipe" : "client stream");
+
+  struct mallinfo2 heap_before = mallinfo2();
+  uint64_t start_ns = monotonic_ns();
+
+  for (unsigned long i = 0; i < iterations; i++) {
+    synth_volume_event(context, i);
+  }
+
+  uint64_t elapsed_ns = monotonic_ns() - start_ns;
+  struct mallinfo2 heap_after = mallinfo2();
+
+  stats_log(&context->stats);
+  double elapsed_s = (double)elapsed_ns / 1e9;
+  log_info("bench: %lu events in %.3fs (%.0f events/sec)", iterations,
+           elapsed_s, (double)iterations / elapsed_s);
+  long heap_delta = (long)heap_after.uordblks - (long)heap_before.uordblks;
+  log_info("bench: heap delta %ld bytes (%.2f bytes/event)", heap_delta,
+           (double)heap_delta / (double)iterations);
+
+  if (context->direct) {
+    if (context->server_fd >= 0) {
+      close(context->server_fd);
+      context->server_fd = -1;
+    }
+    if (stub_pid > 0)
+      waitpid(stub_pid, NULL, 0);
+    unlink(OSD_PIPE_PATH);
+  } else {
+    close(devnull);
+    context->client_stdin_fd = -1;
+  }
+  return 0;
+}
+
+// Replay a recorded trace through the same handling code the live
+// callbacks use, with no PipeWire connection. Dispatches go through the
+// persistent-client write path into /dev/null, so the measured time is
+// the monitor's own work on the recorded event pattern.
+static int run_replay(Context *context, const char *path, double speed) {
+  TraceReader reader;
+  if (!trace_reader_open(&reader, path)) {
+    log_error("Failed to open trace file: %s", path);
+    return 1;
+  }
+
+  int devnull = open("/dev/null", O_WRONLY);
+  if (devnull == -1) {
+    log_error("Failed to open /dev/null: %s", strerror(errno));
+    trace_reader_close(&reader);
+    return 1;
+  }
+  context->client_stdin_fd = devnull;
+
+  // The coalescing timer needs a running main loop, which replay does not
+  // have; every event reaches dispatch
+  context->coalesce_interval_ms = 0;
+
+  if (speed > 0.0)
+    log_info("Replaying %s at %gx speed", path, speed);
+  else
+    log_info("Replaying %s as fast as possible", path);
+
+  uint64_t first_ns = 0;
+  uint64_t wall_start = monotonic_ns();
+  unsigned long events = 0;
+  TraceRecord record;
+  char name[512];
+  int rc;
+
+  while ((rc = trace_reader_next(&reader, &record, name, sizeof(name))) == 1) {
+    if (record.endpoint >= ENDPOINT_COUNT) {
+      continue;
+    }
+    Endpoint *endpoint = &context->endpoints[record.endpoint];
+
+    // Reproduce the recorded inter-event spacing, scaled by speed
+    if (first_ns == 0)
+      first_ns = record.mono_ns;
+    if (speed > 0.0) {
+      uint64_t due = wall_start +
+                     (uint64_t)((double)(record.mono_ns - first_ns) / speed);
+      uint64_t now = monotonic_ns();
+      if (due > now)
+        g_usleep((due - now) / 1000);
+    }
+
+    switch (record.type) {
+    case TRACE_EVENT_VOLUME: {
+      context->event_start_ns = monotonic_ns();
+      context->stats.events_seen++;
+      GVariantBuilder builder;
+      g_variant_builder_init(&builder, G_VARIANT_TYPE_VARDICT);
+      g_variant_builder_add(&builder, "{sv}", "volume",
+                            g_variant_new_double(record.volume));
+      g_variant_builder_add(&builder, "{sv}", "step",
+                            g_variant_new_double(record.step));
+      g_variant_builder_add(&builder, "{sv}", "mute",
+                            g_variant_new_boolean(record.muted));
+      handle_volume_variant(endpoint, g_variant_builder_end(&builder));
+      events++;
+      break;
+    }
+    case TRACE_EVENT_DEFAULT_NODE:
+      g_free(endpoint->default_node_name);
+      endpoint->default_node_name = g_strdup(name);
+      endpoint->node_id = record.node_id;
+      endpoint->has_last_state = false;
+      events++;
+      break;
+    default:
+      break;
+    }
+  }
+  trace_reader_close(&reader);
+  if (rc == -1) {
+    log_warn("Trace %s ends with a malformed record", path);
+  }
+
+  uint64_t elapsed_ns = monotonic_ns() - wall_start;
+  stats_log(&context->stats);
+  double elapsed_s = (double)elapsed_ns / 1e9;
+  log_info("replay: %lu events in %.3fs (%.0f events/sec)", events, elapsed_s,
+           elapsed_s > 0.0 ? (double)events / elapsed_s : 0.0);
+
+  close(devnull);
+  context->client_stdin_fd = -1;
+  return 0;
+}
+
+// Hot-reload of the device-map file: parse into a fresh table (arena and
+// match index included), then swap it in and free the old one. Lookups
+// and this callback share the main loop, so the swap races with nothing.
+static void on_device_map_changed(Context *context,
+                                  __attribute__((unused)) GFile *file,
+                                  __attribute__((unused)) GFile *other_file,
+                                  GFileMonitorEvent event) {
+  // Wait for a complete write; plain CHANGED events can be mid-write,
+  // CREATED covers editors and rollout tools that rename a new file over
+  if (event != G_FILE_MONITOR_EVENT_CHANGES_DONE_HINT &&
+      event != G_FILE_MONITOR_EVENT_CREATED) {
+    return;
+  }
+
+  DeviceMappings fresh = {0};
+  if (!load_device_mappings(context->device_map_file, &fresh)) {
+    log_warn("Device map reload failed, keeping %zu existing mappings",
+             context->device_mappings->count);
+    return;
+  }
+
+  // The index is shared: every seat sees the new table at once
+  free_device_mappings(context->device_mappings);
+  *context->device_mappings = fresh;
+  log_info("Device map reloaded: %zu mappings", fresh.count);
+}
+
+static void setup_device_map_watch(Context *context) {
+  GFile *file = g_file_new_for_path(context->device_map_file);
+  GError *error = NULL;
+  context->device_map_monitor =
+      g_file_monitor_file(file, G_FILE_MONITOR_NONE, NULL, &error);
+  g_object_unref(file);
+
+  if (context->device_map_monitor == NULL) {
+    log_warn("Device map hot-reload unavailable: %s", error->message);
+    g_error_free(error);
+    return;
+  }
+
+  g_signal_connect_swapped(context->device_map_monitor, "changed",
+                           G_CALLBACK(on_device_map_changed), context);
+  log_info("Watching %s for device map changes", context->device_map_file);
+}
+
+// SIGUSR1 dumps the latency histograms and counters of every seat
+// without stopping the daemon; delivered through the main loop, so it
+// races with nothing.
+static gboolean on_sigusr1(gpointer user_data) {
+  GPtrArray *contexts = user_data;
+  for (guint i = 0; i < contexts->len; i++) {
+    Context *context = g_ptr_array_index(contexts, i);
+    log_info("stats: seat %s", seat_label(context));
+    stats_log(&context->stats);
+  }
+  return G_SOURCE_CONTINUE;
+}
+
+// --- Deferred log drain -------------------------------------------------
+// In daemon mode log lines sit formatted in the ring until this idle
+// source writes them out. It runs at G_PRIORITY_LOW, below every event
+// source and dispatch timer, so the OSD write never waits behind stderr
+// I/O. The source exists only while the ring holds messages: log.c calls
+// schedule_log_pump() on the empty-to-non-empty transition and the
+// source removes itself once drained, so an idle daemon stays idle.
+
+#define LOG_PUMP_BATCH 64
+
+static bool log_pump_scheduled = false;
+
+static gboolean on_log_pump(__attribute__((unused)) gpointer user_data) {
+  if (log_pump(LOG_PUMP_BATCH) > 0) {
+    return G_SOURCE_CONTINUE;
+  }
+  log_pump_scheduled = false;
+  return G_SOURCE_REMOVE;
+}
+
+static void schedule_log_pump(__attribute__((unused)) void *udata) {
+  // All log call sites run on the main loop, so no locking is needed
+  if (log_pump_scheduled) {
+    return;
+  }
+  log_pump_scheduled = true;
+  g_idle_add_full(G_PRIORITY_LOW, on_log_pump, NULL, NULL);
+}
+
+// --- Optional extra event sources on the shared main loop --------------
+// Brightness and lock-key OSDs otherwise need their own polling daemons;
+// registering them as GSources here means one process and one set of
+// idle wakeups for all three display types.
+
+static gboolean on_led_event(__attribute__((unused)) GIOChannel *channel,
+                             GIOCondition condition, gpointer user_data) {
+  Context *context = user_data;
+
+  if (condition & (G_IO_HUP | G_IO_ERR)) {
+    log_warn("Keyboard LED device closed, stopping LED watch");
+    return G_SOURCE_REMOVE;
+  }
+
+  struct input_event events[16];
+  ssize_t n = read(context->led_fd, events, sizeof(events));
+  if (n <= 0)
+    return G_SOURCE_CONTINUE;
+
+  for (size_t i = 0; i < (size_t)n / sizeof(events[0]); i++) {
+    const struct input_event *ev = &events[i];
+    if (ev->type != EV_LED)
+      continue;
+
+    const char *name;
+    switch (ev->code) {
+    case LED_NUML:
+      name = "Num Lock";
+      break;
+    case LED_CAPSL:
+      name = "Caps Lock";
+      break;
+    case LED_SCROLLL:
+      name = "Scroll Lock";
+      break;
+    default:
+      continue;
+    }
+
+    char message[128];
+    int len = snprintf(message, sizeof(message),
+                       "{\"type\":\"text\",\"text\":\"%s %s\"}", name,
+                       ev->value ? "On" : "Off");
+    log_info("%s %s", name, ev->value ? "On" : "Off");
+    send_server_message(context, message, (size_t)len);
+  }
+  return G_SOURCE_CONTINUE;
+}
+
+static bool setup_led_watch(Context *context, const char *device) {
+  context->led_fd = open(device, O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+  if (context->led_fd == -1) {
+    log_error("Failed to open LED device %s: %s", device, strerror(errno));
+    return false;
+  }
+
+  GIOChannel *channel = g_io_channel_unix_new(context->led_fd);
+  g_io_add_watch(channel, G_IO_IN | G_IO_HUP | G_IO_ERR, on_led_event, context);
+  g_io_channel_unref(channel);
+  log_info("Watching keyboard LEDs on %s", device);
+  return true;
+}
+
+static int read_sysfs_int(const char *path) {
+  char buf[32];
+  int fd = open(path, O_RDONLY | O_CLOEXEC);
+  if (fd == -1)
+    return -1;
+  ssize_t n = read(fd, buf, sizeof(buf) - 1);
+  close(fd);
+  if (n <= 0)
+    return -1;
+  buf[n] = '\0';
+  return atoi(buf);
+}
+
+static gboolean on_backlight_event(__attribute__((unused)) GIOChannel *channel,
+                                   __attribute__((unused)) GIOCondition condition,
+                                   gpointer user_data) {
+  Context *context = user_data;
+
+  // The inotify payload only tells us "it changed"; drain it and reread
+  char buf[4096];
+  while (read(context->backlight_inotify_fd, buf, sizeof(buf)) > 0)
+    ;
+
+  int value = read_sysfs_int(context->backlight_brightness_path);
+  if (value < 0)
+    return G_SOURCE_CONTINUE;
+
+  char message[128];
+  int len = snprintf(message, sizeof(message),
+                     "{\"type\":\"brightness\",\"value\":%d,\"max_value\":%d}",
+                     value, context->backlight_max);
+  log_info("Brightness: %d/%d", value, context->backlight_max);
+  send_server_message(context, message, (size_t)len);
+  return G_SOURCE_CONTINUE;
+}
+
+static bool setup_backlight_watch(Context *context, const char *dir) {
+  gchar *max_path = g_strdup_printf("%s/max_brightness", dir);
+  context->backlight_max = read_sysfs_int(max_path);
+  g_free(max_path);
+  if (context->backlight_max <= 0) {
+    log_error("Failed to read %s/max_brightness", dir);
+    return false;
+  }
+
+  context->backlight_brightness_path = g_strdup_printf("%s/brightness", dir);
+  context->backlight_inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (context->backlight_inotify_fd == -1 ||
+      inotify_add_watch(context->backlight_inotify_fd,
+                        context->backlight_brightness_path,
+                        IN_MODIFY | IN_CLOSE_WRITE) == -1) {
+    log_error("Failed to watch %s: %s", context->backlight_brightness_path,
+              strerror(errno));
+    return false;
+  }
+
+  GIOChannel *channel = g_io_channel_unix_new(context->backlight_inotify_fd);
+  g_io_add_watch(channel, G_IO_IN, on_backlight_event, context);
+  g_io_channel_unref(channel);
+  log_info("Watching backlight %s (max %d)", dir, context->backlight_max);
+  return true;
 }
 
 void on_plugin_activated(__attribute__((unused)) WpObject *p, GAsyncResult *res,
@@ -273,11 +1319,12 @@ void on_plugin_activated(__attribute__((unused)) WpObject *p, GAsyncResult *res,
 
   if (wp_object_activate_finish(p, res, &error) == 0) {
     log_error("Error activating plugin: %s", error->message);
-    exit(1);
+    schedule_reconnect(context);
     return;
   }
 
   if (--context->pending_plugins == 0) {
+    startup_mark(context, STARTUP_PLUGINS);
     wp_core_install_object_manager(context->core, context->om);
   }
 }
@@ -291,101 +1338,216 @@ void activate_plugins(Context *context) {
   }
 }
 
-void on_mixer_api_loaded(__attribute__((unused)) WpObject *p, GAsyncResult *res,
-                         Context *context) {
-  log_info("Mixer API load callback triggered");
+// Both components load concurrently; the last one to finish kicks off
+// plugin activation, mirroring the pending_plugins countdown below.
+static void on_component_loaded(GAsyncResult *res, Context *context,
+                                const char *plugin_name) {
   gboolean success = wp_core_load_component_finish(context->core, res, NULL);
 
   if (success == FALSE) {
-    log_fatal("Failed to load mixer api");
-    cleanup_context(context);
-    exit(1);
+    log_error("Failed to load %s", plugin_name);
+    schedule_reconnect(context);
+    return;
   }
 
-  log_info("Mixer API loaded");
+  log_info("%s loaded", plugin_name);
 
-  activate_plugins(context);
+  g_ptr_array_add(context->apis, wp_plugin_find(context->core, plugin_name));
+
+  if (--context->pending_components == 0) {
+    startup_mark(context, STARTUP_COMPONENTS);
+    activate_plugins(context);
+  }
+}
+
+void on_mixer_api_loaded(__attribute__((unused)) WpObject *p, GAsyncResult *res,
+                         Context *context) {
+  log_info("Mixer API load callback triggered");
+  on_component_loaded(res, context, "mixer-api");
 }
 
 void on_default_nodes_api_loaded(__attribute__((unused)) WpObject *p,
                                  GAsyncResult *res, Context *context) {
   log_info("Default nodes API load callback triggered");
-  gboolean success = wp_core_load_component_finish(context->core, res, NULL);
+  on_component_loaded(res, context, "default-nodes-api");
+}
 
-  if (success == FALSE) {
-    log_fatal("Failed to load default nodes api");
-    cleanup_context(context);
-    exit(1);
-  }
+// Keep the id -> name cache in sync with the object manager's node set,
+// so event handlers never pay a constrained object-manager scan.
+static void on_node_added(Context *context, gpointer object) {
+  u_int32_t id = wp_proxy_get_bound_id(WP_PROXY(object));
+  const gchar *name =
+      wp_pipewire_object_get_property(WP_PIPEWIRE_OBJECT(object), "node.name");
 
-  log_info("Default nodes API loaded");
+  if (name != NULL) {
+    log_debug("Caching node %d -> %s", id, name);
+    char *copy = scratch_arena_strdup(&context->node_arena, name);
+    if (copy != NULL)
+      g_hash_table_replace(context->node_names, GUINT_TO_POINTER(id), copy);
+  }
+}
 
-  g_ptr_array_add(context->apis,
-                  wp_plugin_find(context->core, "default-nodes-api"));
-  wp_core_load_component(context->core, "libwireplumber-module-mixer-api",
-                         "module", NULL, "mixer-api", NULL,
-                         (GAsyncReadyCallback)on_mixer_api_loaded, context);
+static void on_node_removed(Context *context, gpointer object) {
+  u_int32_t id = wp_proxy_get_bound_id(WP_PROXY(object));
+  g_hash_table_remove(context->node_names, GUINT_TO_POINTER(id));
+  g_hash_table_remove(context->node_states, GUINT_TO_POINTER(id));
 }
 
-void on_mixer_changed(Context *context, u_int32_t id) {
-  log_debug("on_mixer_changed: %d", id);
+// Resolve a node name from the cache, falling back to (and caching) an
+// object-manager lookup on a miss. Returns NULL for unknown nodes.
+static const char *lookup_node_name(Context *context, u_int32_t id) {
+  const char *name =
+      g_hash_table_lookup(context->node_names, GUINT_TO_POINTER(id));
+  if (name != NULL) {
+    return name;
+  }
 
   g_autoptr(WpNode) node = wp_object_manager_lookup(
       context->om, WP_TYPE_NODE, WP_CONSTRAINT_TYPE_G_PROPERTY, "bound-id",
       "=u", id, NULL);
-
   if (node == NULL) {
+    return NULL;
+  }
+
+  const gchar *node_name =
+      wp_pipewire_object_get_property(WP_PIPEWIRE_OBJECT(node), "node.name");
+  if (node_name == NULL) {
+    return NULL;
+  }
+
+  char *copy = scratch_arena_strdup(&context->node_arena, node_name);
+  if (copy == NULL) {
+    return NULL;
+  }
+  g_hash_table_replace(context->node_names, GUINT_TO_POINTER(id), copy);
+  return copy;
+}
+
+static void handle_mixer_event(Context *context, u_int32_t id) {
+  context->event_start_ns = monotonic_ns();
+  context->stats.events_seen++;
+  log_debug("on_mixer_changed: %d", id);
+
+  const char *name = lookup_node_name(context, id);
+
+  if (name == NULL) {
     log_warn("Failed to find node with id %d", id);
     return;
   }
 
-  const gchar *name =
-      wp_pipewire_object_get_property(WP_PIPEWIRE_OBJECT(node), "name");
+  // Refresh the cache for every node the signal names, not just the
+  // current defaults, so a later default-device switch displays instantly
+  NodeVolumeState *state = refresh_node_state(context, id);
 
-  if (context->node_id != id) {
-    log_debug("Ignoring mixed update for node: id: %d, name: %s as it is not "
-              "the default node: %s with id: %d",
-              id, name, context->default_node_name, context->node_id);
+  if (context->event_start_ns != 0) {
+    histogram_record(&context->stats.signal_to_update,
+                     monotonic_ns() - context->event_start_ns);
+  }
+
+  if (state == NULL) {
+    log_error("Node %d doesn't support volume", id);
     return;
   }
 
-  on_update_volume(context, id);
+  for (int i = 0; i < ENDPOINT_COUNT; i++) {
+    Endpoint *endpoint = &context->endpoints[i];
+    if (endpoint->enabled && endpoint->node_id == id) {
+      handle_volume_state(endpoint, state);
+      return;
+    }
+  }
+
+  log_debug("Cached mixer update for node: id: %d, name: %s (not a "
+            "monitored default node)",
+            id, name);
 }
 
-void on_default_nodes_api_changed(Context *context) {
-  log_debug("on_default_nodes_api_changed");
+// Sample the process-wide allocation counter around one event's handling
+// (an ALLOC_COUNT build; a no-op otherwise), so the SIGUSR1 dump shows
+// how many steady-state events touched the heap at all.
+void on_mixer_changed(Context *context, u_int32_t id) {
+  uint64_t allocs_before = alloc_count_total();
+
+  handle_mixer_event(context, id);
+
+  uint64_t allocs = alloc_count_total() - allocs_before;
+  if (allocs > 0) {
+    context->stats.events_allocating++;
+    context->stats.event_allocs += allocs;
+  }
+}
+
+static void update_default_node(Endpoint *endpoint) {
+  Context *context = endpoint->context;
 
   u_int32_t default_node_id;
   g_signal_emit_by_name(context->def_nodes_api, "get-default-node",
-                        "Audio/Sink", &default_node_id);
+                        endpoint->media_class, &default_node_id);
 
   if (!is_valid_node_id(default_node_id)) {
-    log_warn("Invalid default node id: %d", default_node_id);
+    log_warn("Invalid default %s node id: %d", endpoint->media_class,
+             default_node_id);
     return;
   }
 
-  g_autoptr(WpNode) node = wp_object_manager_lookup(
-      context->om, WP_TYPE_NODE, WP_CONSTRAINT_TYPE_G_PROPERTY, "bound-id",
-      "=u", default_node_id, NULL);
+  const char *default_node_name = lookup_node_name(context, default_node_id);
 
-  if (node == NULL) {
+  if (default_node_name == NULL) {
     log_warn("Failed to find node with id %d", default_node_id);
     return;
   }
 
-  const gchar *default_node_name =
-      wp_pipewire_object_get_property(WP_PIPEWIRE_OBJECT(node), "node.name");
-  
-  if (g_strcmp0(default_node_name, context->default_node_name) == 0 && context->node_id == default_node_id) {
-    log_debug("Default node name and id match, ignoring");
+  if (g_strcmp0(default_node_name, endpoint->default_node_name) == 0 && endpoint->node_id == default_node_id) {
+    log_debug("Default %s name and id match, ignoring", endpoint->media_class);
     return;
   }
 
-  log_debug("Default node changed to %s with id %d", default_node_name, default_node_id);
+  log_debug("Default %s changed to %s with id %d", endpoint->media_class,
+            default_node_name, default_node_id);
+
+  g_free(endpoint->default_node_name);
+  endpoint->default_node_name = g_strdup(default_node_name);
+  endpoint->node_id = default_node_id;
+
+  if (context->warm_state_ok) {
+    WarmStateSlot *slot = warm_state_slot(
+        &context->warm_state, (uint32_t)(endpoint - context->endpoints));
+    slot->node_id = default_node_id;
+    g_strlcpy(slot->node_name, default_node_name, sizeof(slot->node_name));
+  }
+
+  // A different device's state is never a duplicate of the old one
+  endpoint->has_last_state = false;
+
+  // If earlier mixer signals already populated the cache for this node,
+  // show its volume immediately instead of waiting for the next change
+  NodeVolumeState *state = g_hash_table_lookup(
+      context->node_states, GUINT_TO_POINTER(default_node_id));
+  if (state != NULL) {
+    context->event_start_ns = 0; // not a mixer signal, keep it out of latency
+    handle_volume_state(endpoint, state);
+  }
 
-  g_free(context->default_node_name);
-  context->default_node_name = g_strdup(default_node_name);
-  context->node_id = default_node_id;
+  if (context->tracing) {
+    TraceRecord record = {
+        .mono_ns = monotonic_ns(),
+        .type = TRACE_EVENT_DEFAULT_NODE,
+        .endpoint = (uint8_t)(endpoint - context->endpoints),
+        .node_id = default_node_id,
+        .name_len = (uint16_t)strlen(default_node_name),
+    };
+    trace_writer_record(&context->trace, &record, default_node_name);
+  }
+}
+
+void on_default_nodes_api_changed(Context *context) {
+  log_debug("on_default_nodes_api_changed");
+
+  for (int i = 0; i < ENDPOINT_COUNT; i++) {
+    if (context->endpoints[i].enabled) {
+      update_default_node(&context->endpoints[i]);
+    }
+  }
 }
 
 void on_object_manager_installed(Context *context) {
@@ -394,29 +1556,216 @@ void on_object_manager_installed(Context *context) {
   context->def_nodes_api = wp_plugin_find(context->core, "default-nodes-api");
 
   if (context->def_nodes_api == NULL) {
-    log_fatal("Default nodes API not loaded");
-    cleanup_context(context);
-    exit(1);
+    log_error("Default nodes API not loaded");
+    schedule_reconnect(context);
+    return;
   }
 
   context->mixer_api = wp_plugin_find(context->core, "mixer-api");
 
   if (context->mixer_api == NULL) {
-    log_fatal("Mixer API not loaded");
-    cleanup_context(context);
-    exit(1);
+    log_error("Mixer API not loaded");
+    schedule_reconnect(context);
+    return;
   }
 
-  g_signal_emit_by_name(context->def_nodes_api,
-                        "get-default-configured-node-name", "Audio/Sink",
-                        &context->default_node_name);
-  g_signal_emit_by_name(context->def_nodes_api, "get-default-node",
-                        "Audio/Sink", &context->node_id);
-  
+  for (int i = 0; i < ENDPOINT_COUNT; i++) {
+    Endpoint *endpoint = &context->endpoints[i];
+    if (!endpoint->enabled)
+      continue;
+    // The query's return location replaces any warm-restored name
+    g_free(endpoint->default_node_name);
+    endpoint->default_node_name = NULL;
+    g_signal_emit_by_name(context->def_nodes_api,
+                          "get-default-configured-node-name",
+                          endpoint->media_class, &endpoint->default_node_name);
+    g_signal_emit_by_name(context->def_nodes_api, "get-default-node",
+                          endpoint->media_class, &endpoint->node_id);
+  }
+
+
   g_signal_connect_swapped(context->mixer_api, "changed",
                            G_CALLBACK(on_mixer_changed), context);
   g_signal_connect_swapped(context->def_nodes_api, "changed",
                            G_CALLBACK(on_default_nodes_api_changed), context);
+
+  // Fully wired up again: cancel any retry still pending and start the
+  // next outage from a short delay
+  if (context->reconnect_timer_id != 0) {
+    g_source_remove(context->reconnect_timer_id);
+    context->reconnect_timer_id = 0;
+  }
+  context->reconnect_delay_ms = RECONNECT_INITIAL_DELAY_MS;
+
+  startup_mark(context, STARTUP_READY);
+  startup_report(context);
+}
+
+static gboolean on_reconnect_timeout(gpointer user_data);
+
+static void schedule_reconnect(Context *context) {
+  if (context->reconnect_timer_id != 0)
+    return;
+
+  if (context->reconnect_delay_ms == 0)
+    context->reconnect_delay_ms = RECONNECT_INITIAL_DELAY_MS;
+
+  log_info("Reconnecting to PipeWire in %u ms", context->reconnect_delay_ms);
+  context->reconnect_timer_id =
+      g_timeout_add(context->reconnect_delay_ms, on_reconnect_timeout, context);
+
+  context->reconnect_delay_ms *= 2;
+  if (context->reconnect_delay_ms > RECONNECT_MAX_DELAY_MS)
+    context->reconnect_delay_ms = RECONNECT_MAX_DELAY_MS;
+}
+
+static void on_core_disconnected(Context *context) {
+  log_warn("PipeWire connection lost (seat %s)", seat_label(context));
+  schedule_reconnect(context);
+}
+
+// (Re)build the WpCore, object manager and plugin set from scratch. The
+// configuration in Context survives untouched, so this is the only work a
+// PipeWire restart costs us.
+static void start_connection(Context *context) {
+  log_info("Connecting to pipewire (seat %s)...", seat_label(context));
+
+  // A named seat selects its PipeWire instance via remote.name; NULL
+  // properties keep the library default socket
+  WpProperties *props =
+      context->seat_name != NULL
+          ? wp_properties_new("remote.name", context->seat_name, NULL)
+          : NULL;
+  context->core = wp_core_new(NULL, NULL, props);
+  context->om = wp_object_manager_new();
+  context->apis = g_ptr_array_new_with_free_func(g_object_unref);
+
+  g_signal_connect_swapped(context->core, "disconnected",
+                           G_CALLBACK(on_core_disconnected), context);
+
+  if (!wp_core_connect(context->core)) {
+    log_error("Failed to connect to PipeWire daemon");
+    schedule_reconnect(context);
+    return;
+  }
+  startup_mark(context, STARTUP_CONNECTED);
+
+  wp_object_manager_add_interest(context->om, WP_TYPE_NODE,
+                                 WP_CONSTRAINT_TYPE_PW_PROPERTY, "media.class",
+                                 "=s", "Audio/Sink", NULL);
+  if (context->endpoints[ENDPOINT_SOURCE].enabled) {
+    wp_object_manager_add_interest(context->om, WP_TYPE_NODE,
+                                   WP_CONSTRAINT_TYPE_PW_PROPERTY,
+                                   "media.class", "=s", "Audio/Source", NULL);
+  }
+
+  g_signal_connect_swapped(context->om, "installed",
+                           G_CALLBACK(on_object_manager_installed), context);
+  g_signal_connect_swapped(context->om, "object-added",
+                           G_CALLBACK(on_node_added), context);
+  g_signal_connect_swapped(context->om, "object-removed",
+                           G_CALLBACK(on_node_removed), context);
+
+  // The two component loads are independent async operations on the same
+  // core, so issue them concurrently and rendezvous in on_component_loaded()
+  context->pending_components = 2;
+  wp_core_load_component(
+      context->core, "libwireplumber-module-default-nodes-api", "module", NULL,
+      "default-nodes-api", NULL,
+      (GAsyncReadyCallback)on_default_nodes_api_loaded, context);
+  wp_core_load_component(context->core, "libwireplumber-module-mixer-api",
+                         "module", NULL, "mixer-api", NULL,
+                         (GAsyncReadyCallback)on_mixer_api_loaded, context);
+}
+
+static gboolean on_reconnect_timeout(gpointer user_data) {
+  Context *context = user_data;
+  context->reconnect_timer_id = 0;
+  teardown_connection(context);
+  start_connection(context);
+  return G_SOURCE_REMOVE;
+}
+
+// Adopt the previous run's default-node identity and dedupe state so
+// events can be served before the startup queries answer; once they do,
+// update_default_node() reconciles against the live default.
+static void restore_warm_state(Context *context) {
+  for (uint32_t i = 0; i < ENDPOINT_COUNT; i++) {
+    Endpoint *endpoint = &context->endpoints[i];
+    WarmStateSlot *slot = warm_state_slot(&context->warm_state, i);
+    if (!endpoint->enabled || !slot->has_state || slot->node_name[0] == '\0')
+      continue;
+    endpoint->node_id = slot->node_id;
+    endpoint->default_node_name = g_strdup(slot->node_name);
+    endpoint->has_last_state = true;
+    endpoint->last_volume = slot->volume;
+    endpoint->last_muted = slot->muted != 0;
+    log_info("Restored %s state: node %u '%s', %d%%%s", endpoint->media_class,
+             slot->node_id, slot->node_name, slot->volume,
+             slot->muted ? " (muted)" : "");
+  }
+}
+
+// Build one seat's Context: private caches, endpoints, stats and
+// delivery state, pointing at the shared device-map index. Warm state
+// goes to a per-seat file so seats do not clobber each other.
+static Context *create_seat_context(const struct arguments *arguments,
+                                    const char *seat_name,
+                                    DeviceMappings *mappings) {
+  Context *context = g_new0(Context, 1);
+  context->seat_name = seat_name;
+  // Values of both caches live in node_arena, not the heap, so no value
+  // destructors: entries are dropped on removal and the arena resets
+  // wholesale on reconnect
+  context->node_names = g_hash_table_new(g_direct_hash, g_direct_equal);
+  context->node_states = g_hash_table_new(g_direct_hash, g_direct_equal);
+  scratch_arena_init(&context->node_arena, 4096);
+  context->client_path = arguments->client_path;
+  init_spawn_argv(context);
+  context->client_stdin_fd = -1;
+  context->direct = arguments->direct;
+  context->server_fd = -1;
+  context->led_fd = -1;
+  context->backlight_inotify_fd = -1;
+  context->show_device_name = arguments->show_device_name;
+  context->coalesce_interval_ms = arguments->coalesce_interval_ms;
+  context->device_mappings = mappings;
+  init_endpoints(context, arguments->monitor_source);
+  volume_curve_init(&context->volume_curve, arguments->curve_exponent);
+
+  if (g_strcmp0(arguments->state_file, "none") != 0) {
+    gchar *state_file;
+    if (arguments->state_file != NULL) {
+      state_file = seat_name != NULL
+                       ? g_strdup_printf("%s.%s", arguments->state_file,
+                                         seat_name)
+                       : g_strdup(arguments->state_file);
+    } else {
+      gchar *name = seat_name != NULL
+                        ? g_strdup_printf("wayland-osd-monitor.%s.state",
+                                          seat_name)
+                        : g_strdup("wayland-osd-monitor.state");
+      state_file = g_build_filename(g_get_user_runtime_dir(), name, NULL);
+      g_free(name);
+    }
+    context->warm_state_ok =
+        warm_state_open(&context->warm_state, state_file, ENDPOINT_COUNT);
+    if (context->warm_state_ok) {
+      restore_warm_state(context);
+    } else {
+      log_warn("Failed to open state file %s, continuing without warm restart",
+               state_file);
+    }
+    g_free(state_file);
+  }
+
+  return context;
+}
+
+static void cleanup_seats(GPtrArray *contexts) {
+  for (guint i = 0; i < contexts->len; i++)
+    cleanup_context(g_ptr_array_index(contexts, i));
+  g_ptr_array_free(contexts, TRUE);
 }
 
 bool check_client_executable(const char *client_path) {
@@ -434,32 +1783,106 @@ bool check_client_executable(const char *client_path) {
 }
 
 int main(int argc, char *argv[]) {
+  uint64_t main_start_ns = monotonic_ns();
   struct arguments arguments;
   arguments.client_path = NULL;
   arguments.show_device_name = false;
   arguments.device_map_file = NULL;
+  arguments.coalesce_interval_ms = DEFAULT_COALESCE_INTERVAL_MS;
+  arguments.soak_iterations = 0;
+  arguments.log_ring_file = NULL;
+  arguments.direct = false;
+  arguments.monitor_source = false;
+  arguments.led_device = NULL;
+  arguments.backlight_dir = NULL;
+  arguments.bench_iterations = 0;
+  arguments.record_file = NULL;
+  arguments.replay_file = NULL;
+  arguments.replay_speed = 1.0;
+  arguments.curve_exponent = 1.0 / 3.0; // cubic, the PipeWire default
+  arguments.state_file = NULL;
+  arguments.seats = NULL;
 
   argp_parse(&argp, argc, argv, 0, 0, &arguments);
 
+  // Keep stderr flushing off the event-dispatch path. The synthetic
+  // modes have no main loop to pump, so they drain on a flusher thread;
+  // the daemon instead defers writes to a low-priority idle source (see
+  // on_log_pump), keeping log I/O strictly after OSD dispatch.
+  if (arguments.soak_iterations > 0 || arguments.bench_iterations > 0 ||
+      arguments.replay_file != NULL) {
+    log_set_async(true);
+  } else {
+    log_set_deferred(true);
+    log_set_pump_notify(schedule_log_pump, NULL);
+  }
+
+  if (arguments.log_ring_file) {
+    if (log_add_ringfile(arguments.log_ring_file, LOG_TRACE,
+                         LOG_RING_DEFAULT_SIZE) != 0) {
+      log_error("Failed to open log ring file: %s", arguments.log_ring_file);
+      return 1;
+    }
+    log_info("Binary ring log enabled: %s", arguments.log_ring_file);
+  }
+
   if (arguments.device_map_file) {
     log_info("Loading device mappings from: %s", arguments.device_map_file);
   }
 
-  if (!check_client_executable(arguments.client_path)) {
+  // Soak, bench and replay modes need neither the client binary nor a
+  // PipeWire connection
+  if (arguments.soak_iterations > 0 || arguments.bench_iterations > 0 ||
+      arguments.replay_file != NULL) {
+    Context *synth_context = g_new0(Context, 1);
+    synth_context->client_path = arguments.client_path;
+    synth_context->client_stdin_fd = -1;
+    synth_context->server_fd = -1;
+    synth_context->led_fd = -1;
+    synth_context->backlight_inotify_fd = -1;
+    synth_context->direct = arguments.direct;
+    synth_context->show_device_name = arguments.show_device_name;
+    // Traces may contain source-endpoint records, so enable both
+    init_endpoints(synth_context, arguments.replay_file != NULL);
+    volume_curve_init(&synth_context->volume_curve, arguments.curve_exponent);
+    DeviceMappings synth_mappings = {0};
+    if (!load_device_mappings(arguments.device_map_file, &synth_mappings)) {
+      log_error("Failed to load device mappings");
+      g_free(synth_context);
+      return 1;
+    }
+    synth_context->device_mappings = &synth_mappings;
+    int ret;
+    if (arguments.replay_file != NULL) {
+      ret = run_replay(synth_context, arguments.replay_file,
+                       arguments.replay_speed);
+    } else if (arguments.bench_iterations > 0) {
+      ret = run_bench(synth_context, arguments.bench_iterations);
+    } else {
+      ret = run_soak(synth_context, arguments.soak_iterations);
+    }
+    for (int i = 0; i < ENDPOINT_COUNT; i++)
+      g_free(synth_context->endpoints[i].default_node_name);
+    free_device_mappings(&synth_mappings);
+    g_free(synth_context);
+    return ret;
+  }
+
+  // Direct mode talks to the server itself; the client binary is unused
+  if (!arguments.direct && !check_client_executable(arguments.client_path)) {
     return 1;
   }
 
+  // A dead client must surface as EPIPE on our write, not kill the daemon
+  signal(SIGPIPE, SIG_IGN);
+
   wp_init(WP_INIT_PIPEWIRE);
-  Context *context = g_new0(Context, 1);
-  context->core = wp_core_new(NULL, NULL, NULL);
-  context->om = wp_object_manager_new();
-  context->apis = g_ptr_array_new_with_free_func(g_object_unref);
-  context->client_path = arguments.client_path;
-  context->show_device_name = arguments.show_device_name;
-  
-  if (!load_device_mappings(arguments.device_map_file, &context->device_mappings)) {
+
+  // One immutable device-map index for the whole process; every seat's
+  // lookups go through the same arena and match index
+  DeviceMappings mappings = {0};
+  if (!load_device_mappings(arguments.device_map_file, &mappings)) {
     log_error("Failed to load device mappings");
-    g_free(context);
     return 1;
   }
 
@@ -467,32 +1890,69 @@ int main(int argc, char *argv[]) {
   if (arguments.show_device_name) {
     log_info("Device name display enabled");
   }
-  if (arguments.device_map_file && context->device_mappings.count > 0) {
-    log_info("Loaded %zu device name mappings", context->device_mappings.count);
+  if (arguments.device_map_file && mappings.count > 0) {
+    log_info("Loaded %zu device name mappings", mappings.count);
   }
-  log_info("Connecting to pipewire...");
 
-  if (!wp_core_connect(context->core)) {
-    log_fatal("Failed to connect to PipeWire daemon");
-    g_ptr_array_unref(context->apis);
-    g_object_unref(context->om);
-    g_object_unref(context->core);
-    g_free(context);
+  // One Context per seat, all sources on the one main loop. Without
+  // --seat this is a single default-socket seat, exactly as before.
+  GPtrArray *contexts = g_ptr_array_new();
+  guint seat_count = arguments.seats != NULL ? arguments.seats->len : 1;
+  for (guint i = 0; i < seat_count; i++) {
+    const char *seat_name =
+        arguments.seats != NULL ? g_ptr_array_index(arguments.seats, i) : NULL;
+    g_ptr_array_add(contexts,
+                    create_seat_context(&arguments, seat_name, &mappings));
+  }
+  Context *primary = g_ptr_array_index(contexts, 0);
+
+  // Machine-wide sources live on the primary context only: the device-map
+  // watcher swaps the shared index, and the hardware watchers and event
+  // trace exist once per process
+  if (arguments.device_map_file) {
+    primary->device_map_file = arguments.device_map_file;
+    setup_device_map_watch(primary);
+  }
+  if (arguments.record_file) {
+    if (!trace_writer_open(&primary->trace, arguments.record_file)) {
+      log_error("Failed to open trace file: %s", arguments.record_file);
+      cleanup_seats(contexts);
+      free_device_mappings(&mappings);
+      return 1;
+    }
+    primary->tracing = true;
+    log_info("Recording events to %s", arguments.record_file);
+  }
+  if (arguments.led_device && !setup_led_watch(primary, arguments.led_device)) {
+    cleanup_seats(contexts);
+    free_device_mappings(&mappings);
+    return 1;
+  }
+  if (arguments.backlight_dir &&
+      !setup_backlight_watch(primary, arguments.backlight_dir)) {
+    cleanup_seats(contexts);
+    free_device_mappings(&mappings);
     return 1;
   }
 
   log_info("Starting wayland-osd-wireplumber-monitor");
-  wp_object_manager_add_interest(context->om, WP_TYPE_NODE,
-                                 WP_CONSTRAINT_TYPE_PW_PROPERTY, "media.class",
-                                 "=s", "Audio/Sink", NULL);
+  if (arguments.monitor_source) {
+    log_info("Also monitoring the default Audio/Source");
+  }
+  if (seat_count > 1) {
+    log_info("Multi-seat mode: %u PipeWire instances", seat_count);
+  }
 
-  g_signal_connect_swapped(context->om, "installed",
-                           G_CALLBACK(on_object_manager_installed), context);
+  // A failed first connect is handled like a mid-session outage: stay
+  // alive and keep retrying with backoff instead of making the supervisor
+  // re-pay full startup on every attempt
+  for (guint i = 0; i < contexts->len; i++) {
+    Context *context = g_ptr_array_index(contexts, i);
+    context->startup_stage_ns[STARTUP_MAIN] = main_start_ns;
+    start_connection(context);
+  }
 
-  wp_core_load_component(
-      context->core, "libwireplumber-module-default-nodes-api", "module", NULL,
-      "default-nodes-api", NULL,
-      (GAsyncReadyCallback)on_default_nodes_api_loaded, context);
+  g_unix_signal_add(SIGUSR1, on_sigusr1, contexts);
 
   // Create and run the main loop
   GMainLoop *loop = g_main_loop_new(NULL, FALSE);
@@ -500,6 +1960,9 @@ int main(int argc, char *argv[]) {
 
   // Cleanup (this will only run after the loop is quit)
   g_main_loop_unref(loop);
-  cleanup_context(context);
+  cleanup_seats(contexts);
+  free_device_mappings(&mappings);
+  if (arguments.seats != NULL)
+    g_ptr_array_free(arguments.seats, TRUE);
   return 0;
 }
@@ -0,0 +1,87 @@
+// Offline decoder for the binary ring-file log sink (log_add_ringfile).
+// Prints the surviving window of records, oldest first, with monotonic
+// timestamps relative to the first decoded record.
+
+#define _GNU_SOURCE
+#include "../lib/log-ring.h"
+#include "../lib/log.h" // level constants
+
+#include <fcntl.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static const char *level_strings[] = {
+  "TRACE", "DEBUG", "INFO", "WARN", "ERROR", "FATAL"
+};
+
+int main(int argc, char *argv[]) {
+  if (argc != 2) {
+    fprintf(stderr, "usage: %s RINGFILE\n", argv[0]);
+    return 2;
+  }
+
+  int fd = open(argv[1], O_RDONLY);
+  if (fd == -1) {
+    perror(argv[1]);
+    return 1;
+  }
+
+  struct stat st;
+  if (fstat(fd, &st) == -1 || (size_t)st.st_size < sizeof(LogRingHeader)) {
+    fprintf(stderr, "%s: not a ring log file\n", argv[1]);
+    close(fd);
+    return 1;
+  }
+
+  void *map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (map == MAP_FAILED) {
+    perror("mmap");
+    return 1;
+  }
+
+  const LogRingHeader *header = map;
+  if (memcmp(header->magic, LOG_RING_MAGIC, sizeof(header->magic)) != 0 ||
+      header->version != LOG_RING_VERSION || header->record_count == 0) {
+    fprintf(stderr, "%s: bad magic or unsupported version\n", argv[1]);
+    return 1;
+  }
+
+  size_t expected = sizeof(LogRingHeader) +
+                    (size_t)header->record_count * sizeof(LogRingRecord);
+  if ((size_t)st.st_size < expected) {
+    fprintf(stderr, "%s: truncated record area\n", argv[1]);
+    return 1;
+  }
+
+  const LogRingRecord *records =
+      (const LogRingRecord *)((const char *)map + sizeof(LogRingHeader));
+
+  uint64_t first = header->next_index > header->record_count
+                       ? header->next_index - header->record_count
+                       : 0;
+  uint64_t base_ns = 0;
+
+  for (uint64_t i = first; i < header->next_index; i++) {
+    const LogRingRecord *rec = &records[i % header->record_count];
+    if (rec->level > LOG_FATAL || rec->file_len + rec->msg_len > LOG_RING_TEXT_MAX) {
+      continue; // torn or garbage slot
+    }
+    if (base_ns == 0) {
+      base_ns = rec->mono_ns;
+    }
+    uint64_t rel = rec->mono_ns - base_ns;
+    printf("[+%5" PRIu64 ".%06" PRIu64 "] %-5s %.*s:%u: %.*s\n",
+           (uint64_t)(rel / 1000000000ull),
+           (uint64_t)((rel % 1000000000ull) / 1000),
+           level_strings[rec->level], (int)rec->file_len, rec->text,
+           rec->line, (int)rec->msg_len, rec->text + rec->file_len);
+  }
+
+  munmap(map, (size_t)st.st_size);
+  return 0;
+}